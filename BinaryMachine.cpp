@@ -0,0 +1,202 @@
+/*
+ * BinaryMachine.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+#include "BinaryMachine.h"
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using std::string;
+using std::vector;
+using std::pair;
+using std::make_pair;
+using std::unordered_map;
+
+static const char BINARY_MACHINE_MAGIC[8] = {'M','E','M','I','N','B','I','N'};
+static const uint32_t BINARY_MACHINE_VERSION = 1;
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+inline uint64_t align8(uint64_t nBytes) {
+	return (nBytes+7) & ~(uint64_t)7;
+}
+
+inline unsigned int seqWordCount(uint32_t seqLength) {
+	return (seqLength-1)/IncSpecSeq::WORD_BITS +1;
+}
+
+void writePadding(std::ofstream& out, uint64_t nBytes) {
+	static const char zeros[8] = {0};
+	out.write(zeros, align8(nBytes)-nBytes);
+}
+
+void saveBinaryMachine(string filename, vector<vector<pair<IncSpecSeq*,pair<int, IncSpecSeq*> > > >& states, vector<IncSpecSeq*>& inputs, int resetState, int numInputBits, int numOutputBits) {
+	//the inputs get the indexes 0, ..., inputs.size()-1; outputs that are not also inputs are appended in the order of their first occurrence
+	vector<IncSpecSeq*> seqs(inputs);
+	unordered_map<IncSpecSeq*, uint32_t> seqIndex;
+	for (unsigned int i=0; i<inputs.size(); i++) {
+		seqIndex[inputs[i]] = i;
+	}
+
+	uint64_t nTransitions = 0;
+	for (unsigned int s=0; s<states.size(); s++) {
+		for (vector<pair<IncSpecSeq*,pair<int, IncSpecSeq*> > >::iterator it=states[s].begin(); it!=states[s].end(); it++) {
+			IncSpecSeq* output = it->second.second;
+			if (seqIndex.insert(make_pair(output, (uint32_t)seqs.size())).second) seqs.push_back(output);
+			nTransitions++;
+		}
+	}
+
+	BinaryMachineHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, BINARY_MACHINE_MAGIC, sizeof(header.magic));
+	header.version = BINARY_MACHINE_VERSION;
+	header.byteOrderMark = BYTE_ORDER_MARK;
+	header.resetState = resetState;
+	header.numInputBits = numInputBits;
+	header.numOutputBits = numOutputBits;
+	header.nStates = states.size();
+	header.nSeqs = seqs.size();
+	header.nInputs = inputs.size();
+	header.nTransitions = nTransitions;
+	for (unsigned int i=0; i<seqs.size(); i++) {
+		header.nSeqWords += 2*seqs[i]->seq.size();
+	}
+
+	std::ofstream out(filename.c_str(), std::ios::binary);
+	if (!out) {
+		std::cerr << "Unable to open file "<<filename << std::endl;
+		exit(1);
+	}
+
+	out.write((const char*)&header, sizeof(header));
+
+	vector<uint32_t> seqLengths(seqs.size());
+	for (unsigned int i=0; i<seqs.size(); i++) {
+		seqLengths[i] = seqs[i]->seqLength;
+	}
+	if (!seqLengths.empty()) out.write((const char*)&seqLengths[0], seqLengths.size()*sizeof(uint32_t));
+	writePadding(out, seqLengths.size()*sizeof(uint32_t));
+
+	for (unsigned int i=0; i<seqs.size(); i++) {
+		out.write((const char*)seqs[i]->seq.data(), seqs[i]->seq.size()*sizeof(uint64_t));
+		out.write((const char*)seqs[i]->specifiedBits.data(), seqs[i]->specifiedBits.size()*sizeof(uint64_t));
+	}
+
+	vector<uint64_t> transStart(states.size()+1, 0);
+	vector<BinaryTransition> transitions;
+	transitions.reserve(nTransitions);
+	for (unsigned int s=0; s<states.size(); s++) {
+		for (vector<pair<IncSpecSeq*,pair<int, IncSpecSeq*> > >::iterator it=states[s].begin(); it!=states[s].end(); it++) {
+			BinaryTransition t;
+			t.input = seqIndex[it->first];
+			t.nextState = it->second.first;
+			t.output = seqIndex[it->second.second];
+			transitions.push_back(t);
+		}
+		transStart[s+1] = transitions.size();
+	}
+	out.write((const char*)&transStart[0], transStart.size()*sizeof(uint64_t));
+	if (!transitions.empty()) out.write((const char*)&transitions[0], transitions.size()*sizeof(BinaryTransition));
+
+	out.close();
+	if (!out) {
+		std::cerr << "Error while writing file "<<filename << std::endl;
+		exit(1);
+	}
+}
+
+void invalidBinaryMachine(const string& filename, const char* reason) {
+	std::cerr << "Invalid binary machine file " << filename << ": " << reason << std::endl;
+	exit(1);
+}
+
+//returns the end of a section of count elements of elemSize bytes that starts at offset; the program is terminated if the section does not fit
+//into the file (the check cannot overflow, as offset <= fileSize)
+uint64_t checkedSectionEnd(const string& filename, uint64_t offset, uint64_t count, uint64_t elemSize, uint64_t fileSize) {
+	if (offset > fileSize || count > (fileSize-offset)/elemSize) invalidBinaryMachine(filename, "file too small");
+	return offset + count*elemSize;
+}
+
+void loadBinaryMachine(string filename, vector<vector<pair<IncSpecSeq*,pair<int, IncSpecSeq*> > > >& states, vector<IncSpecSeq*>& inputs, int& resetState, int& numInputBits, int& numOutputBits) {
+	int fd = open(filename.c_str(), O_RDONLY);
+	struct stat st;
+	if (fd<0 || fstat(fd, &st)!=0) {
+		std::cerr << "Unable to open file "<<filename << std::endl;
+		exit(1);
+	}
+	uint64_t fileSize = st.st_size;
+	if (fileSize < sizeof(BinaryMachineHeader)) invalidBinaryMachine(filename, "file too small");
+
+	void* mem = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mem==MAP_FAILED) {
+		std::cerr << "Unable to map file "<<filename << std::endl;
+		exit(1);
+	}
+	const char* data = (const char*)mem;
+
+	const BinaryMachineHeader& header = *(const BinaryMachineHeader*)data;
+	if (memcmp(header.magic, BINARY_MACHINE_MAGIC, sizeof(header.magic))!=0) invalidBinaryMachine(filename, "wrong magic number");
+	if (header.byteOrderMark!=BYTE_ORDER_MARK) invalidBinaryMachine(filename, "wrong byte order");
+	if (header.version!=BINARY_MACHINE_VERSION) invalidBinaryMachine(filename, "unsupported version");
+	if (header.nInputs>header.nSeqs || header.resetState<-1 || header.resetState>=(int64_t)header.nStates) invalidBinaryMachine(filename, "inconsistent header");
+	if (header.numInputBits<0 || header.numOutputBits<0) invalidBinaryMachine(filename, "negative number of input or output bits");
+
+	//the counts in the header are not trusted; each section is checked against the file size before the next offset is computed
+	uint64_t seqLengthsOffset = sizeof(BinaryMachineHeader);
+	uint64_t seqWordsOffset = align8(checkedSectionEnd(filename, seqLengthsOffset, header.nSeqs, sizeof(uint32_t), fileSize));
+	uint64_t transStartOffset = checkedSectionEnd(filename, seqWordsOffset, header.nSeqWords, sizeof(uint64_t), fileSize);
+	uint64_t transitionsOffset = checkedSectionEnd(filename, transStartOffset, (uint64_t)header.nStates+1, sizeof(uint64_t), fileSize);
+	if (checkedSectionEnd(filename, transitionsOffset, header.nTransitions, sizeof(BinaryTransition), fileSize) != fileSize) invalidBinaryMachine(filename, "wrong file size");
+
+	const uint32_t* seqLengths = (const uint32_t*)(data+seqLengthsOffset);
+	const uint64_t* seqWords = (const uint64_t*)(data+seqWordsOffset);
+	const uint64_t* transStart = (const uint64_t*)(data+transStartOffset);
+	const BinaryTransition* transitions = (const BinaryTransition*)(data+transitionsOffset);
+
+	vector<IncSpecSeq*> seqs(header.nSeqs);
+	uint64_t curWord = 0;
+	for (unsigned int i=0; i<header.nSeqs; i++) {
+		if (seqLengths[i]==0) invalidBinaryMachine(filename, "empty sequence");
+		unsigned int nWords = seqWordCount(seqLengths[i]);
+		if (curWord + 2*nWords > header.nSeqWords) invalidBinaryMachine(filename, "sequence data too short");
+		seqs[i] = new IncSpecSeq();
+		seqs[i]->init(seqLengths[i], seqWords+curWord, seqWords+curWord+nWords);
+		curWord += 2*nWords;
+	}
+	if (curWord != header.nSeqWords) invalidBinaryMachine(filename, "sequence data too long");
+
+	//the KISS writer sizes its line buffers by numInputBits and numOutputBits, so all sequences must have exactly these lengths
+	inputs.assign(seqs.begin(), seqs.begin()+header.nInputs);
+	for (unsigned int i=0; i<header.nInputs; i++) {
+		if (inputs[i]->seqLength!=(unsigned int)header.numInputBits) invalidBinaryMachine(filename, "input length differs from the number of input bits");
+		inputs[i]->id = i;
+	}
+
+	if (transStart[0]!=0 || transStart[header.nStates]!=header.nTransitions) invalidBinaryMachine(filename, "inconsistent transition table");
+	states.assign(header.nStates, vector<pair<IncSpecSeq*,pair<int, IncSpecSeq*> > >());
+	for (unsigned int s=0; s<header.nStates; s++) {
+		if (transStart[s+1]<transStart[s] || transStart[s+1]>header.nTransitions) invalidBinaryMachine(filename, "inconsistent transition table");
+		states[s].reserve(transStart[s+1]-transStart[s]);
+		for (uint64_t t=transStart[s]; t<transStart[s+1]; t++) {
+			const BinaryTransition& trans = transitions[t];
+			if (trans.input>=header.nInputs || trans.output>=header.nSeqs || trans.nextState<0 || trans.nextState>=(int64_t)header.nStates) invalidBinaryMachine(filename, "invalid transition");
+			if (seqs[trans.output]->seqLength!=(unsigned int)header.numOutputBits) invalidBinaryMachine(filename, "output length differs from the number of output bits");
+			states[s].push_back(make_pair(seqs[trans.input], make_pair((int)trans.nextState, seqs[trans.output])));
+		}
+	}
+
+	resetState = header.resetState;
+	numInputBits = header.numInputBits;
+	numOutputBits = header.numOutputBits;
+
+	munmap(mem, fileSize);
+}
@@ -0,0 +1,49 @@
+/*
+ * BinaryMachine.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef BINARYMACHINE_H_
+#define BINARYMACHINE_H_
+
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "IncSpecSeq.h"
+
+//binary representation of a parsed machine; all values are stored in the byte order of the machine that wrote the file
+//layout (all sections start at 8-byte boundaries):
+//  BinaryMachineHeader
+//  uint32_t seqLengths[nSeqs]
+//  uint64_t seqWords[]: for each sequence, its seq words followed by its specifiedBits words
+//  uint64_t transStart[nStates+1]
+//  BinaryTransition transitions[nTransitions]
+//the first nInputs sequences are the inputs (in the order of their ids)
+struct BinaryMachineHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrderMark;
+	int32_t resetState;
+	int32_t numInputBits;
+	int32_t numOutputBits;
+	uint32_t nStates;
+	uint32_t nSeqs;
+	uint32_t nInputs;
+	uint64_t nSeqWords;
+	uint64_t nTransitions;
+};
+
+struct BinaryTransition {
+	uint32_t input;
+	int32_t nextState;
+	uint32_t output;
+};
+
+void saveBinaryMachine(std::string filename, std::vector<std::vector<std::pair<IncSpecSeq*,std::pair<int, IncSpecSeq*> > > >& states, std::vector<IncSpecSeq*>& inputs, int resetState, int numInputBits, int numOutputBits);
+
+//same interface as parseKISSFile
+void loadBinaryMachine(std::string filename, std::vector<std::vector<std::pair<IncSpecSeq*,std::pair<int, IncSpecSeq*> > > >& states, std::vector<IncSpecSeq*>& inputs, int& resetState, int& numInputBits, int& numOutputBits);
+
+#endif /* BINARYMACHINE_H_ */
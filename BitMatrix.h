@@ -0,0 +1,179 @@
+/*
+ * BitMatrix.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef BITMATRIX_H_
+#define BITMATRIX_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+//row-major bit matrix; each row is stored in 64-bit words and starts at a 64-byte boundary
+//bits beyond the last column are always 0
+class BitMatrix {
+public:
+	static const unsigned int WORD_BITS = 64;
+	//rows are padded to a multiple of this number of words (i.e., to cache lines)
+	static const unsigned int ROW_ALIGN_WORDS = 8;
+
+	BitMatrix() : nRows(0), nCols(0), wordsPerRow(0), words(NULL) {
+	}
+
+	BitMatrix(unsigned int nRows, unsigned int nCols) : nRows(0), nCols(0), wordsPerRow(0), words(NULL) {
+		resize(nRows, nCols);
+	}
+
+	BitMatrix(const BitMatrix& other) : nRows(0), nCols(0), wordsPerRow(0), words(NULL) {
+		*this = other;
+	}
+
+	BitMatrix& operator=(const BitMatrix& other) {
+		if (this == &other) return *this;
+		resize(other.nRows, other.nCols);
+		if (words != NULL) memcpy(words, other.words, (size_t)nRows*wordsPerRow*sizeof(uint64_t));
+		return *this;
+	}
+
+	~BitMatrix() {
+		free(words);
+	}
+
+	//all bits are 0 after resizing
+	void resize(unsigned int rows, unsigned int cols) {
+		free(words);
+		words = NULL;
+		nRows = rows;
+		nCols = cols;
+		wordsPerRow = wordsForBits(cols);
+		wordsPerRow = ((wordsPerRow+ROW_ALIGN_WORDS-1)/ROW_ALIGN_WORDS)*ROW_ALIGN_WORDS;
+
+		size_t nBytes = (size_t)nRows*wordsPerRow*sizeof(uint64_t);
+		if (nBytes == 0) return;
+		void* mem;
+		if (posix_memalign(&mem, ROW_ALIGN_WORDS*sizeof(uint64_t), nBytes) != 0) throw std::bad_alloc();
+		words = (uint64_t*)mem;
+		memset(words, 0, nBytes);
+	}
+
+	unsigned int rows() const {
+		return nRows;
+	}
+
+	unsigned int cols() const {
+		return nCols;
+	}
+
+	//number of words that are used for the bits of a row (without padding)
+	unsigned int rowWords() const {
+		return wordsForBits(nCols);
+	}
+
+	static unsigned int wordsForBits(unsigned int nBits) {
+		return (nBits+WORD_BITS-1)/WORD_BITS;
+	}
+
+	bool get(unsigned int r, unsigned int c) const {
+		return (words[(size_t)r*wordsPerRow + c/WORD_BITS] >> (c%WORD_BITS)) & 1;
+	}
+
+	void set(unsigned int r, unsigned int c) {
+		words[(size_t)r*wordsPerRow + c/WORD_BITS] |= ((uint64_t)1 << (c%WORD_BITS));
+	}
+
+	void reset(unsigned int r, unsigned int c) {
+		words[(size_t)r*wordsPerRow + c/WORD_BITS] &= ~((uint64_t)1 << (c%WORD_BITS));
+	}
+
+	const uint64_t* row(unsigned int r) const {
+		return words + (size_t)r*wordsPerRow;
+	}
+
+	uint64_t* row(unsigned int r) {
+		return words + (size_t)r*wordsPerRow;
+	}
+
+	//number of 1 bits in row r
+	unsigned int countRow(unsigned int r) const {
+		const uint64_t* w = row(r);
+		unsigned int c = 0;
+		for (unsigned int i=0; i<rowWords(); i++) c += __builtin_popcountll(w[i]);
+		return c;
+	}
+
+	//dst = dst & row r; dst must have at least rowWords() words
+	void andRow(unsigned int r, uint64_t* dst) const {
+		const uint64_t* w = row(r);
+		for (unsigned int i=0; i<rowWords(); i++) dst[i] &= w[i];
+	}
+
+	//dst = dst & ~(row r); dst must have at least rowWords() words
+	void andNotRow(unsigned int r, uint64_t* dst) const {
+		const uint64_t* w = row(r);
+		for (unsigned int i=0; i<rowWords(); i++) dst[i] &= ~w[i];
+	}
+
+	//dst = dst | row r; dst must have at least rowWords() words
+	void orRow(unsigned int r, uint64_t* dst) const {
+		const uint64_t* w = row(r);
+		for (unsigned int i=0; i<rowWords(); i++) dst[i] |= w[i];
+	}
+
+	//sets the first nBits bits of the word array to 1, and the remaining bits of the last word to 0
+	static void setFirstBits(uint64_t* dst, unsigned int nBits) {
+		unsigned int nWords = wordsForBits(nBits);
+		for (unsigned int i=0; i<nWords; i++) dst[i] = ~(uint64_t)0;
+		if (nBits%WORD_BITS != 0) dst[nWords-1] = ((uint64_t)1 << (nBits%WORD_BITS)) - 1;
+	}
+
+	//index of the first 1 bit at position >= from in the word array, or -1 if there is no such bit
+	static int nextSetBit(const uint64_t* w, unsigned int nBits, unsigned int from) {
+		if (from >= nBits) return -1;
+		unsigned int i = from/WORD_BITS;
+		uint64_t cur = w[i] & (~(uint64_t)0 << (from%WORD_BITS));
+		unsigned int nWords = wordsForBits(nBits);
+		while (true) {
+			if (cur != 0) {
+				unsigned int bit = i*WORD_BITS + __builtin_ctzll(cur);
+				return (bit < nBits) ? (int)bit : -1;
+			}
+			i++;
+			if (i >= nWords) return -1;
+			cur = w[i];
+		}
+	}
+
+	//index of the first 1 bit at position >= from in row r, or -1 if there is no such bit
+	int nextSetBit(unsigned int r, unsigned int from) const {
+		return nextSetBit(row(r), nCols, from);
+	}
+
+	//index of the first 0 bit at position >= from in row r, or -1 if there is no such bit
+	int nextUnsetBit(unsigned int r, unsigned int from) const {
+		if (from >= nCols) return -1;
+		const uint64_t* w = row(r);
+		unsigned int i = from/WORD_BITS;
+		uint64_t cur = ~w[i] & (~(uint64_t)0 << (from%WORD_BITS));
+		while (true) {
+			if (cur != 0) {
+				unsigned int bit = i*WORD_BITS + __builtin_ctzll(cur);
+				return (bit < nCols) ? (int)bit : -1;
+			}
+			i++;
+			if (i >= rowWords()) return -1;
+			cur = ~w[i];
+		}
+	}
+
+private:
+	unsigned int nRows;
+	unsigned int nCols;
+	//row stride in words, including padding
+	unsigned int wordsPerRow;
+	uint64_t* words;
+};
+
+#endif /* BITMATRIX_H_ */
@@ -64,12 +64,14 @@ void computeReducedInputAlphabet(unordered_set<int>& reducedInputAlphabet, int m
 	}
 }
 
-Solver* S;
+CNFEncoder::CNFEncoder(Solver* solver) : S(solver), simpS(NULL), numClasses(0), curLiteral(1) {
+}
+
+CNFEncoder::CNFEncoder(SimpSolver* solver) : S(solver), simpS(solver), numClasses(0), curLiteral(1) {
+}
 
-int* stateClassToLiteral;
-int curLiteral;
-int getStateLiteral(int state, int sClass, int numClasses) {
-	int key = ai(state, sClass,numClasses);
+int CNFEncoder::getStateLiteral(int state, int sClass) {
+	int key = ai(state, sClass, numClasses);
 
 	int retLiteral = stateClassToLiteral[key];
 	if (retLiteral==-1) {
@@ -80,8 +82,7 @@ int getStateLiteral(int state, int sClass, int numClasses) {
 	return retLiteral;
 }
 
-int* auxLiteralsMap;
-int getAuxLiteral(int j) {
+int CNFEncoder::getAuxLiteral(int j) {
 	int key = j;
 
 	int retLiteral = auxLiteralsMap[key];
@@ -93,11 +94,15 @@ int getAuxLiteral(int j) {
 	return retLiteral;
 }
 
-void addLitToCurrentClause(int lit) {
+void CNFEncoder::addLitToCurrentClause(int lit) {
 	if (S!=NULL) {
 		int var = abs(lit)-1;
 		while (var >= (S->nVars())) {
-			S->newVar();
+			if (simpS!=NULL) {
+				simpS->newVar();
+			} else {
+				S->newVar();
+			}
 		}
 		curMinisatClause.push((lit>0) ? mkLit(var) : ~mkLit(var));
 	} else {
@@ -105,9 +110,13 @@ void addLitToCurrentClause(int lit) {
 	}
 }
 
-void addClause() {
+void CNFEncoder::addClause() {
 	if (S!=NULL) {
-		S->addClause(curMinisatClause);
+		if (simpS!=NULL) {
+			simpS->addClause(curMinisatClause);
+		} else {
+			S->addClause(curMinisatClause);
+		}
 		curMinisatClause.clear();
 	} else {
 		clauses.push_back(curClause);
@@ -115,28 +124,22 @@ void addClause() {
 	}
 }
 
-vector<vector<int> > clauses;
-vec<Lit> curMinisatClause;
-vector<int> curClause;
-
-void buildCNF(Solver* solver, vector<pair<int, int> >& literalToStateClass, unsigned int numClasses, vector<vector<int> >& machineNextState, vector<bool>& incompMatrix, vector<int>& pairwiseIncStates, int maxInput) {
-	S = solver;
+void CNFEncoder::buildCNF(vector<pair<int, int> >& literalToStateClass, unsigned int numClasses, vector<vector<int> >& machineNextState, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, int maxInput) {
 	clauses.clear();
 	curClause.clear();
 	curMinisatClause.clear();
 
 	int nStates = machineNextState.size();
 	curLiteral = 1;
+	this->numClasses = numClasses;
 
-	stateClassToLiteral = new int[nStates*numClasses];
-	for (unsigned int i=0; i<nStates*numClasses; i++) stateClassToLiteral[i]=-1;
-
-	auxLiteralsMap = new int[numClasses];
+	stateClassToLiteral.assign((size_t)nStates*numClasses, -1);
+	auxLiteralsMap.assign(numClasses, -1);
 
 	//add pairwise incompatible states to different classes
 	for (unsigned int i=0; i<pairwiseIncStates.size(); i++) {
 		int s = pairwiseIncStates[i];
-		addLitToCurrentClause(getStateLiteral(s,i,numClasses));
+		addLitToCurrentClause(getStateLiteral(s,i));
 		addClause();
 	}
 
@@ -144,17 +147,22 @@ void buildCNF(Solver* solver, vector<pair<int, int> >& literalToStateClass, unsi
 	statesThatCanBeInClass.resize(numClasses);
 	for (unsigned int i=0; i<numClasses; i++) {
 		vector<int>& curVector = statesThatCanBeInClass[i];
-		for (int s=0; s<nStates; s++) {
-			if (i<pairwiseIncStates.size() && incompMatrix[ai(s, pairwiseIncStates[i], nStates)]) continue;
-			curVector.push_back(s);
+		if (i<pairwiseIncStates.size()) {
+			for (int s=incompMatrix.nextUnsetBit(pairwiseIncStates[i], 0); s!=-1; s=incompMatrix.nextUnsetBit(pairwiseIncStates[i], s+1)) {
+				curVector.push_back(s);
+			}
+		} else {
+			for (int s=0; s<nStates; s++) {
+				curVector.push_back(s);
+			}
 		}
 	}
 
 	//each state must be in at least one class
 	for (int s=0; s<nStates; s++) {
 		for (unsigned int i=0; i<numClasses; i++) {
-			if (i<pairwiseIncStates.size() && incompMatrix[ai(s, pairwiseIncStates[i], nStates)]) continue;
-			addLitToCurrentClause(getStateLiteral(s,i,numClasses));
+			if (i<pairwiseIncStates.size() && incompMatrix.get(s, pairwiseIncStates[i])) continue;
+			addLitToCurrentClause(getStateLiteral(s,i));
 		}
 		addClause();
 	}
@@ -163,20 +171,18 @@ void buildCNF(Solver* solver, vector<pair<int, int> >& literalToStateClass, unsi
 	for (unsigned int i=0; i<pairwiseIncStates.size(); i++) {
 		int s = pairwiseIncStates[i];
 
-		for (int incompS=0; incompS<nStates; incompS++) {
-			if (!incompMatrix[ai(s, incompS, nStates)]) continue;
-			addLitToCurrentClause(-getStateLiteral(incompS,i,numClasses));
+		for (int incompS=incompMatrix.nextSetBit(s, 0); incompS!=-1; incompS=incompMatrix.nextSetBit(s, incompS+1)) {
+			addLitToCurrentClause(-getStateLiteral(incompS,i));
 			addClause();
 		}
 	}
 
 	for (int s=0; s<nStates; s++) {
 		for (unsigned int i=0; i<numClasses; i++) {
-			if (i<pairwiseIncStates.size() && incompMatrix[ai(s, pairwiseIncStates[i], nStates)]) continue;
-			for (int incompS=s+1; incompS<nStates; incompS++) {
-				if (!incompMatrix[ai(s, incompS, nStates)]) continue;
-				addLitToCurrentClause(-getStateLiteral(s,i,numClasses));
-				addLitToCurrentClause(-getStateLiteral(incompS,i,numClasses));
+			if (i<pairwiseIncStates.size() && incompMatrix.get(s, pairwiseIncStates[i])) continue;
+			for (int incompS=incompMatrix.nextSetBit(s, s+1); incompS!=-1; incompS=incompMatrix.nextSetBit(s, incompS+1)) {
+				addLitToCurrentClause(-getStateLiteral(s,i));
+				addLitToCurrentClause(-getStateLiteral(incompS,i));
 				addClause();
 			}
 		}
@@ -212,7 +218,7 @@ void buildCNF(Solver* solver, vector<pair<int, int> >& literalToStateClass, unsi
 				if (succS == -1) continue;
 
 				for (unsigned int j=0; j<numClasses; j++) {
-					if (j<pairwiseIncStates.size() && incompMatrix[ai(succS, pairwiseIncStates[j], nStates)]) continue;
+					if (j<pairwiseIncStates.size() && incompMatrix.get(succS, pairwiseIncStates[j])) continue;
 					possibleSuccClasses[j]=true;
 					if (j<smallestSuccClass) smallestSuccClass=j;
 					if (j>largestSuccClass) largestSuccClass=j;
@@ -238,8 +244,8 @@ void buildCNF(Solver* solver, vector<pair<int, int> >& literalToStateClass, unsi
 					if (!possibleSuccClasses[j]) continue;
 
 					addLitToCurrentClause(-getAuxLiteral(j));
-					addLitToCurrentClause(-getStateLiteral(s,i,numClasses));
-					addLitToCurrentClause(getStateLiteral(succS,j,numClasses));
+					addLitToCurrentClause(-getStateLiteral(s,i));
+					addLitToCurrentClause(getStateLiteral(succS,j));
 					addClause();
 				}
 			}
@@ -249,6 +255,8 @@ void buildCNF(Solver* solver, vector<pair<int, int> >& literalToStateClass, unsi
 	gettimeofday(&end, 0);
 	if (verbosity>=1) cout << "Closure Constraints: "<< (end.tv_usec-start.tv_usec) << " usec" << endl;
 
+	if (symmetryBreaking != SYMMETRY_NONE) addSymmetryBreakingClauses(nStates, pairwiseIncStates);
+
 	pair<int, int> defaultPair(-1,-1);
 
 	literalToStateClass.resize(curLiteral);
@@ -262,3 +270,126 @@ void buildCNF(Solver* solver, vector<pair<int, int> >& literalToStateClass, unsi
 		}
 	}
 }
+
+//the classes that are not fixed by the partial solution are interchangeable; the added clauses exclude (most of) the symmetric assignments
+//the states are ordered such that the states of the partial solution come last; class i is represented by the bit vector (state 0 in i, state 1 in i, ...)
+//SYMMETRY_MIN: min(i) <= min(i+1) for all unfixed classes i, i+1, where min(i) is the smallest state in class i (larger than all states if i is empty)
+//SYMMETRY_LEX: the bit vectors of the unfixed classes are in lexicographically decreasing order (this implies the constraints of SYMMETRY_MIN)
+//every solution can be transformed into a solution that satisfies these constraints by reordering the unfixed classes
+//(states may be in several classes, so constraints that assume that the classes are disjoint would not be sound)
+void CNFEncoder::addSymmetryBreakingClauses(int nStates, vector<int>& pairwiseIncStates) {
+	unsigned int firstFreeClass = pairwiseIncStates.size();
+	if (firstFreeClass+1 >= numClasses) return;
+
+	vector<bool> inPartialSolution(nStates, false);
+	for (unsigned int i=0; i<pairwiseIncStates.size(); i++) inPartialSolution[pairwiseIncStates[i]] = true;
+
+	vector<int> stateOrder;
+	for (int s=0; s<nStates; s++) {
+		if (!inPartialSolution[s]) stateOrder.push_back(s);
+	}
+	stateOrder.insert(stateOrder.end(), pairwiseIncStates.begin(), pairwiseIncStates.end());
+
+	if (symmetryBreaking == SYMMETRY_LEX) {
+		//equal[i] is a literal that is true if the bit vectors of classes i and i+1 are equal for the states considered so far (0 if it is always true)
+		//it is only forced to be true (and not to be false), which suffices to enforce the order
+		vector<int> equal(numClasses, 0);
+		for (unsigned int n=0; n<stateOrder.size(); n++) {
+			int s = stateOrder[n];
+			for (unsigned int i=firstFreeClass; i+1<numClasses; i++) {
+				int lit1 = stateClassToLiteral[ai(s, i, numClasses)];
+				int lit2 = stateClassToLiteral[ai(s, i+1, numClasses)];
+				if (lit1==-1 && lit2==-1) continue;
+
+				//if the vectors are equal so far: s in i+1 -> s in i
+				if (lit2!=-1) {
+					if (equal[i]!=0) addLitToCurrentClause(-equal[i]);
+					addLitToCurrentClause(-lit2);
+					if (lit1!=-1) addLitToCurrentClause(lit1);
+					addClause();
+				}
+
+				if (n+1==stateOrder.size()) continue;
+
+				//if the vectors are equal so far, and s is in both or none of the classes, they are still equal
+				int newEqual = curLiteral++;
+				if (equal[i]!=0) addLitToCurrentClause(-equal[i]);
+				if (lit1!=-1) addLitToCurrentClause(lit1);
+				if (lit2!=-1) addLitToCurrentClause(lit2);
+				addLitToCurrentClause(newEqual);
+				addClause();
+				if (lit1!=-1 && lit2!=-1) {
+					if (equal[i]!=0) addLitToCurrentClause(-equal[i]);
+					addLitToCurrentClause(-lit1);
+					addLitToCurrentClause(-lit2);
+					addLitToCurrentClause(newEqual);
+					addClause();
+				}
+				equal[i] = newEqual;
+			}
+		}
+		return;
+	}
+
+	//prefix[i] is a literal that is true iff class i contains one of the states considered so far (0 if there are no such states)
+	vector<int> prefix(numClasses, 0);
+	for (unsigned int n=0; n<stateOrder.size(); n++) {
+		int s = stateOrder[n];
+		for (unsigned int i=firstFreeClass; i<numClasses; i++) {
+			int stateLit = stateClassToLiteral[ai(s, i, numClasses)];
+			if (stateLit==-1) continue;
+
+			int newPrefix = curLiteral++;
+			//newPrefix <-> prefix[i] || stateLit
+			addLitToCurrentClause(-stateLit);
+			addLitToCurrentClause(newPrefix);
+			addClause();
+			if (prefix[i]!=0) {
+				addLitToCurrentClause(-prefix[i]);
+				addLitToCurrentClause(newPrefix);
+				addClause();
+				addLitToCurrentClause(prefix[i]);
+			}
+			addLitToCurrentClause(stateLit);
+			addLitToCurrentClause(-newPrefix);
+			addClause();
+			prefix[i] = newPrefix;
+		}
+
+		//if class i+1 contains a state <= s, then class i must also contain such a state
+		for (unsigned int i=firstFreeClass; i+1<numClasses; i++) {
+			if (prefix[i+1]==0) continue;
+			addLitToCurrentClause(-prefix[i+1]);
+			if (prefix[i]!=0) addLitToCurrentClause(prefix[i]);
+			addClause();
+		}
+	}
+}
+
+void CNFEncoder::buildIncrementalCNF(vector<pair<int, int> >& literalToStateClass, vector<int>& classActivationLiterals, unsigned int maxClasses, vector<vector<int> >& machineNextState, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, int maxInput) {
+	buildCNF(literalToStateClass, maxClasses, machineNextState, incompMatrix, pairwiseIncStates, maxInput);
+
+	int nStates = machineNextState.size();
+
+	classActivationLiterals.assign(maxClasses, -1);
+	for (unsigned int i=pairwiseIncStates.size(); i<maxClasses; i++) {
+		int actLit = curLiteral++;
+		classActivationLiterals[i] = actLit;
+
+		for (int s=0; s<nStates; s++) {
+			int stateLit = stateClassToLiteral[ai(s,i,maxClasses)];
+			if (stateLit==-1) continue;
+			addLitToCurrentClause(actLit);
+			addLitToCurrentClause(-stateLit);
+			addClause();
+		}
+
+		if (i>pairwiseIncStates.size()) {
+			addLitToCurrentClause(-actLit);
+			addLitToCurrentClause(classActivationLiterals[i-1]);
+			addClause();
+		}
+	}
+
+	literalToStateClass.resize(curLiteral, make_pair(-1,-1));
+}
@@ -12,6 +12,7 @@
 #include <map>
 #include "IncSpecSeq.h"
 #include "minisat/core/Solver.h"
+#include "minisat/simp/SimpSolver.h"
 #include <iostream>
 #include <vector>
 #include <map>
@@ -23,6 +24,7 @@
 
 #include <sys/time.h>
 #include "IncSpecSeq.h"
+#include "BitMatrix.h"
 
 using namespace Minisat;
 
@@ -42,23 +44,6 @@ inline int ai(int x, int y, int ySize) {
 	return x*ySize+y;
 }
 
-extern Solver* S;
-
-extern int* stateClassToLiteral;
-extern int curLiteral;
-int getStateLiteral(int state, int sClass, int numClasses);
-
-extern int* auxLiteralsMap;
-int getAuxLiteral(int i, int j, int numClasses);
-
-extern vector<vector<int> > clauses;
-extern vec<Lit> curMinisatClause;
-extern vector<int> curClause;
-
-void addClause();
-void addLitToCurrentClause(int lit);
-
-
 template <class InputType>
 void computeInputAlphabet(set<InputType>& inputAlphabet, vector<map<InputType, pair<int, IncSpecSeq> > >& states) {
 	for (typename vector<map<InputType, pair<int, IncSpecSeq> > >::iterator vIt = states.begin(); vIt != states.end(); vIt++) {
@@ -129,6 +114,51 @@ void computeReducedInputAlphabet(set<InputType>& reducedInputAlphabet, map<Input
 	}
 }
 
-void buildCNF(Solver* solver, vector<pair<int, int> >& literalToStateClass, unsigned int numClasses, vector<vector<int> >& machineNextState, vector<bool>& incompMatrix, vector<int>& pairwiseIncStates, int maxInput);
+//builds the CNF formula for a given number of classes
+//all state is owned by the encoder, so several encoders can be used concurrently (e.g., one per thread)
+class CNFEncoder {
+public:
+	//the clauses are added to solver; if solver is NULL, they are stored in clauses instead
+	CNFEncoder(Solver* solver);
+	//the clauses are added to solver in a way that allows for simplification by variable elimination
+	CNFEncoder(SimpSolver* solver);
+
+	//clauses in DIMACS format (only used if there is no solver)
+	vector<vector<int> > clauses;
+
+	//if literal i is true, and literalToStateClass[i]=(s,c) then state s is in class c
+	void buildCNF(vector<pair<int, int> >& literalToStateClass, unsigned int numClasses, vector<vector<int> >& machineNextState, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, int maxInput);
+
+	//like buildCNF, but encodes maxClasses classes, each of which (except for the classes of the partial solution) is guarded by an activation literal
+	//classActivationLiterals[i] is the activation literal of class i (or -1 if class i is always active); if it is false, no state may be in class i
+	//class i can only be active if class i-1 is active, thus assuming the negation of classActivationLiterals[k] restricts the solution to k classes
+	void buildIncrementalCNF(vector<pair<int, int> >& literalToStateClass, vector<int>& classActivationLiterals, unsigned int maxClasses, vector<vector<int> >& machineNextState, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, int maxInput);
+
+	//number of literals that have been used so far
+	int nLiterals() const {
+		return curLiteral-1;
+	}
+
+private:
+	Solver* S;
+	//S if it is a SimpSolver (its newVar and addClause hide the methods of Solver), NULL otherwise
+	SimpSolver* simpS;
+
+	unsigned int numClasses;
+	int curLiteral;
+	vector<int> stateClassToLiteral;
+	vector<int> auxLiteralsMap;
+
+	vec<Lit> curMinisatClause;
+	vector<int> curClause;
+
+	int getStateLiteral(int state, int sClass);
+	int getAuxLiteral(int j);
+
+	void addLitToCurrentClause(int lit);
+	void addClause();
+
+	void addSymmetryBreakingClauses(int nStates, vector<int>& pairwiseIncStates);
+};
 
 #endif /* DIMACSWRITER_H_ */
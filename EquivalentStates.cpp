@@ -0,0 +1,241 @@
+/*
+ * EquivalentStates.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+#include "EquivalentStates.h"
+#include <algorithm>
+
+using std::vector;
+using std::pair;
+using std::make_pair;
+
+//partition of the states into blocks; the states of each block are stored consecutively in elems
+//during a splitting step, the marked states of block b are elems[first[b]], ..., elems[mid[b]-1]
+class RefinablePartition {
+public:
+	RefinablePartition(int nStates) : elems(nStates), loc(nStates), block(nStates) {
+	}
+
+	vector<int> elems;
+	//position of each state in elems
+	vector<int> loc;
+	//block of each state
+	vector<int> block;
+	vector<int> first;
+	vector<int> mid;
+	vector<int> end;
+
+	int nBlocks() const {
+		return first.size();
+	}
+
+	//the states elems[start], ..., elems[stop-1] form a new block
+	int addBlock(int start, int stop) {
+		int b = first.size();
+		first.push_back(start);
+		mid.push_back(start);
+		end.push_back(stop);
+		for (int i=start; i<stop; i++) {
+			block[elems[i]] = b;
+			loc[elems[i]] = i;
+		}
+		return b;
+	}
+
+	void mark(int s) {
+		int b = block[s];
+		int i = loc[s];
+		if (i < mid[b]) return;
+		if (mid[b]==first[b]) touched.push_back(b);
+
+		int m = mid[b];
+		std::swap(elems[i], elems[m]);
+		loc[elems[i]] = i;
+		loc[elems[m]] = m;
+		mid[b]++;
+	}
+
+	//splits each block with marked states into its marked and its unmarked states, and unmarks all states
+	//newBlocks contains pairs (b, nb), where nb is the new block with the marked states of b
+	void split(vector<pair<int, int> >& newBlocks) {
+		newBlocks.clear();
+		for (unsigned int i=0; i<touched.size(); i++) {
+			int b = touched[i];
+			if (mid[b]==end[b]) {
+				mid[b] = first[b];
+				continue;
+			}
+			int nb = addBlock(first[b], mid[b]);
+			first[b] = mid[b];
+			newBlocks.push_back(make_pair(b, nb));
+		}
+		touched.clear();
+	}
+
+private:
+	vector<int> touched;
+};
+
+//orders states by the inputs and outputs of their transitions; sig[s] contains the pairs (input id, output) of state s in increasing order
+struct SignatureLess {
+	vector<vector<pair<int, IncSpecSeq*> > >* sig;
+	bool operator()(int s1, int s2) const {
+		vector<pair<int, IncSpecSeq*> >& sig1 = (*sig)[s1];
+		vector<pair<int, IncSpecSeq*> >& sig2 = (*sig)[s2];
+		if (sig1.size() != sig2.size()) return sig1.size() < sig2.size();
+		for (unsigned int i=0; i<sig1.size(); i++) {
+			if (sig1[i].first != sig2[i].first) return sig1[i].first < sig2[i].first;
+			if (*sig1[i].second < *sig2[i].second) return true;
+			if (*sig2[i].second < *sig1[i].second) return false;
+		}
+		return false;
+	}
+};
+
+struct InputOutputLess {
+	bool operator()(const pair<int, IncSpecSeq*>& p1, const pair<int, IncSpecSeq*>& p2) const {
+		if (p1.first != p2.first) return p1.first < p2.first;
+		return *p1.second < *p2.second;
+	}
+};
+
+int mergeEquivalentStates(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, int& resetState, int nInputs) {
+	int nStates = states.size();
+	if (nStates==0) return 0;
+
+	//states with several transitions for the same input are never merged
+	vector<vector<pair<int, IncSpecSeq*> > > sig(nStates);
+	vector<int> mergeableStates;
+	vector<int> otherStates;
+	for (int s=0; s<nStates; s++) {
+		for (unsigned int t=0; t<states[s].size(); t++) {
+			sig[s].push_back(make_pair(states[s][t].first->id, states[s][t].second.second));
+		}
+		std::sort(sig[s].begin(), sig[s].end(), InputOutputLess());
+
+		bool mergeable = true;
+		for (unsigned int i=1; i<sig[s].size(); i++) {
+			if (sig[s][i].first==sig[s][i-1].first) mergeable = false;
+		}
+		if (mergeable) {
+			mergeableStates.push_back(s);
+		} else {
+			otherStates.push_back(s);
+		}
+	}
+
+	//initial partition: states with the same inputs and outputs
+	RefinablePartition partition(nStates);
+	SignatureLess less;
+	less.sig = &sig;
+	std::stable_sort(mergeableStates.begin(), mergeableStates.end(), less);
+	int pos = 0;
+	for (unsigned int i=0; i<mergeableStates.size(); i++) {
+		partition.elems[pos+i] = mergeableStates[i];
+	}
+	for (unsigned int i=0; i<mergeableStates.size(); ) {
+		unsigned int j = i+1;
+		while (j<mergeableStates.size() && !less(mergeableStates[i], mergeableStates[j])) j++;
+		partition.addBlock(i, j);
+		i = j;
+	}
+	pos = mergeableStates.size();
+	for (unsigned int i=0; i<otherStates.size(); i++) {
+		partition.elems[pos] = otherStates[i];
+		partition.addBlock(pos, pos+1);
+		pos++;
+	}
+	vector<vector<pair<int, IncSpecSeq*> > >().swap(sig);
+
+	//incoming transitions of each state t: inPred[k] has a transition with input inInput[k] to t, for inStart[t] <= k < inStart[t+1]
+	vector<int> inStart(nStates+1, 0);
+	for (int s=0; s<nStates; s++) {
+		for (unsigned int t=0; t<states[s].size(); t++) inStart[states[s][t].second.first+1]++;
+	}
+	for (int s=0; s<nStates; s++) inStart[s+1] += inStart[s];
+	vector<int> inPred(inStart[nStates]);
+	vector<int> inInput(inStart[nStates]);
+	vector<int> inPos(inStart.begin(), inStart.end()-1);
+	for (int s=0; s<nStates; s++) {
+		for (unsigned int t=0; t<states[s].size(); t++) {
+			int k = inPos[states[s][t].second.first]++;
+			inPred[k] = s;
+			inInput[k] = states[s][t].first->id;
+		}
+	}
+
+	//all initial blocks are splitters; afterwards, if a block that is not a splitter is split, it suffices to use the smaller part as a splitter
+	vector<int> worklist;
+	vector<bool> inWorklist(nStates, false);
+	for (int b=0; b<partition.nBlocks(); b++) {
+		worklist.push_back(b);
+		inWorklist[b] = true;
+	}
+
+	//incoming transitions of the current splitter, as pairs (input, predecessor), grouped by input
+	vector<vector<int> > predsByInput(nInputs);
+	vector<int> usedInputs;
+	vector<pair<int, int> > newBlocks;
+
+	while (!worklist.empty()) {
+		int b = worklist.back();
+		worklist.pop_back();
+		inWorklist[b] = false;
+
+		for (int i=partition.first[b]; i<partition.end[b]; i++) {
+			int t = partition.elems[i];
+			for (int k=inStart[t]; k<inStart[t+1]; k++) {
+				if (predsByInput[inInput[k]].empty()) usedInputs.push_back(inInput[k]);
+				predsByInput[inInput[k]].push_back(inPred[k]);
+			}
+		}
+
+		for (unsigned int i=0; i<usedInputs.size(); i++) {
+			vector<int>& preds = predsByInput[usedInputs[i]];
+			for (unsigned int j=0; j<preds.size(); j++) partition.mark(preds[j]);
+			preds.clear();
+
+			partition.split(newBlocks);
+			for (unsigned int j=0; j<newBlocks.size(); j++) {
+				int oldB = newBlocks[j].first;
+				int newB = newBlocks[j].second;
+				if (inWorklist[oldB] || partition.end[newB]-partition.first[newB] <= partition.end[oldB]-partition.first[oldB]) {
+					worklist.push_back(newB);
+					inWorklist[newB] = true;
+				} else {
+					worklist.push_back(oldB);
+					inWorklist[oldB] = true;
+				}
+			}
+		}
+		usedInputs.clear();
+	}
+
+	int nBlocks = partition.nBlocks();
+	if (nBlocks==nStates) return 0;
+
+	//the blocks are numbered in the order of their first states; the first state of each block is kept
+	vector<int> blockNumber(nBlocks, -1);
+	vector<int> keptStates;
+	for (int s=0; s<nStates; s++) {
+		int b = partition.block[s];
+		if (blockNumber[b]!=-1) continue;
+		blockNumber[b] = keptStates.size();
+		keptStates.push_back(s);
+	}
+
+	vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > > newStates(nBlocks);
+	for (int i=0; i<nBlocks; i++) {
+		newStates[i].swap(states[keptStates[i]]);
+		for (unsigned int t=0; t<newStates[i].size(); t++) {
+			int& nextState = newStates[i][t].second.first;
+			nextState = blockNumber[partition.block[nextState]];
+		}
+	}
+	states.swap(newStates);
+
+	if (resetState!=-1) resetState = blockNumber[partition.block[resetState]];
+
+	return nStates - nBlocks;
+}
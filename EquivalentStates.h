@@ -0,0 +1,22 @@
+/*
+ * EquivalentStates.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef EQUIVALENTSTATES_H_
+#define EQUIVALENTSTATES_H_
+
+#include <vector>
+#include <utility>
+
+#include "IncSpecSeq.h"
+
+//merges states that are equivalent, i.e., that have transitions for the same inputs, with identical outputs (including unspecified bits),
+//and equivalent successors; such states can be replaced by a single state without changing the size of a minimal machine
+//the equivalence is computed by partition refinement (Hopcroft's algorithm, with the transitions of each state as a partial function)
+//states with several transitions for the same input are not merged
+//the states are renumbered, resetState is updated accordingly; nInputs is the number of (interned) inputs; returns the number of removed states
+int mergeEquivalentStates(std::vector<std::vector<std::pair<IncSpecSeq*, std::pair<int, IncSpecSeq*> > > >& states, int& resetState, int nInputs);
+
+#endif /* EQUIVALENTSTATES_H_ */
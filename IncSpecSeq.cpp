@@ -9,11 +9,11 @@
 
 std::ostream& operator<< (std::ostream &out, IncSpecSeq& output) {
 	for (unsigned int i=0; i<output.seqLength; i++) {
-		int curPos = i%(sizeof(int)*8);
-		if (((output.specifiedBits[i/(sizeof(int)*8)]>>curPos)&1)==0) {
+		int curPos = i%IncSpecSeq::WORD_BITS;
+		if (((output.specifiedBits[i/IncSpecSeq::WORD_BITS]>>curPos)&1)==0) {
 			out<<"-";
 		} else {
-			out<<((output.seq[i/(sizeof(int)*8)]>>curPos)&1);
+			out<<((output.seq[i/IncSpecSeq::WORD_BITS]>>curPos)&1);
 		}
 	}
 	return out;
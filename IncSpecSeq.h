@@ -11,72 +11,208 @@
 #include <iostream>
 #include <vector>
 #include <set>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+#include "IncSpecSeqKernels.h"
 
 using std::string;
 using std::vector;
 using std::set;
 
+//sequence of 64-bit words; up to INLINE_WORDS words are stored inline, longer sequences are stored on the heap (aligned to HEAP_ALIGN bytes)
+class WordBuffer {
+public:
+	static const unsigned int INLINE_WORDS = 2;
+	static const unsigned int HEAP_ALIGN = 32;
+
+	WordBuffer() : nWords(0) {
+	}
+
+	WordBuffer(const WordBuffer& other) : nWords(0) {
+		*this = other;
+	}
+
+	WordBuffer& operator=(const WordBuffer& other) {
+		if (this == &other) return *this;
+		resize(other.nWords, 0);
+		memcpy(data(), other.data(), nWords*sizeof(uint64_t));
+		return *this;
+	}
+
+	~WordBuffer() {
+		if (nWords > INLINE_WORDS) free(heapWords);
+	}
+
+	//all words are set to value
+	void resize(unsigned int n, uint64_t value) {
+		if (nWords > INLINE_WORDS) free(heapWords);
+		nWords = n;
+		if (nWords > INLINE_WORDS) {
+			void* mem;
+			if (posix_memalign(&mem, HEAP_ALIGN, nWords*sizeof(uint64_t)) != 0) throw std::bad_alloc();
+			heapWords = (uint64_t*)mem;
+		}
+		uint64_t* w = data();
+		for (unsigned int i=0; i<nWords; i++) w[i] = value;
+	}
+
+	unsigned int size() const {
+		return nWords;
+	}
+
+	uint64_t* data() {
+		return (nWords > INLINE_WORDS) ? heapWords : inlineWords;
+	}
+
+	const uint64_t* data() const {
+		return (nWords > INLINE_WORDS) ? heapWords : inlineWords;
+	}
+
+	uint64_t& operator[](unsigned int i) {
+		return data()[i];
+	}
+
+	uint64_t operator[](unsigned int i) const {
+		return data()[i];
+	}
+
+	bool operator==(const WordBuffer& other) const {
+		if (nWords != other.nWords) return false;
+		return memcmp(data(), other.data(), nWords*sizeof(uint64_t)) == 0;
+	}
+
+	bool operator!=(const WordBuffer& other) const {
+		return !(*this == other);
+	}
+
+	//lexicographic order
+	bool operator<(const WordBuffer& other) const {
+		const uint64_t* w1 = data();
+		const uint64_t* w2 = other.data();
+		for (unsigned int i=0; i<nWords && i<other.nWords; i++) {
+			if (w1[i] != w2[i]) return w1[i] < w2[i];
+		}
+		return nWords < other.nWords;
+	}
+
+	bool operator>(const WordBuffer& other) const {
+		return other < *this;
+	}
+
+private:
+	unsigned int nWords;
+	union {
+		uint64_t inlineWords[INLINE_WORDS];
+		uint64_t* heapWords;
+	};
+};
 
 class IncSpecSeq {
 public:
+	static const unsigned int WORD_BITS = 64;
+	//sequences with at least this number of words are compared using the (SIMD) kernels from IncSpecSeqKernels.h
+	static const unsigned int KERNEL_MIN_WORDS = 4;
+
 	//the i-th bit is 1 iff the i-th element is specified and 1, otherwise the bit is 0
-	vector<unsigned int> seq;
+	WordBuffer seq;
 
 	//the i-th bit is 0 iff the i-th element is not specified
-	vector<unsigned int> specifiedBits;
+	WordBuffer specifiedBits;
 
 	//in bits
 	unsigned int seqLength;
 
-	//the first seqLength%(sizeof(int)*8) bits are 1
-	unsigned int lastMask;
+	//the first seqLength%WORD_BITS bits are 1
+	uint64_t lastMask;
 
 	bool fullySpecified;
 
+	//dense ID of an input that was interned by the parser (-1 if the sequence is not such an input)
+	int id;
+
 	IncSpecSeq() {
 		seqLength = 0;
 		lastMask = 0;
 		fullySpecified = true;
+		id = -1;
 	}
 
 	IncSpecSeq(string& s) {
-		seqLength=s.length();
-		unsigned int vecLength = (seqLength-1)/(sizeof(int)*8) +1;
+		init(s.c_str(), s.length());
+	}
+
+	//s does not need to be null-terminated
+	IncSpecSeq(const char* s, unsigned int length) {
+		init(s, length);
+	}
+
+	void init(const char* s, unsigned int length) {
+		id = -1;
+		seqLength=length;
+		unsigned int vecLength = (seqLength-1)/WORD_BITS +1;
 
-		seq.clear();
 		seq.resize(vecLength, 0);
-		specifiedBits.clear();
 		specifiedBits.resize(vecLength, 0);
 
 		fullySpecified = true;
+		lastMask = 0;
 
-		for (unsigned int i=0; i<s.length(); i++) {
-			unsigned int& curOutputInt = seq[i/(sizeof(int)*8)];
-			unsigned int& curSpecBitsInt = specifiedBits[i/(sizeof(int)*8)];
-			int curPos = i%(sizeof(int)*8);
+		for (unsigned int i=0; i<length; i++) {
+			uint64_t& curOutputInt = seq[i/WORD_BITS];
+			uint64_t& curSpecBitsInt = specifiedBits[i/WORD_BITS];
+			int curPos = i%WORD_BITS;
 
 			char c = s[i];
 			if (c=='0' || c=='1') {
-				curSpecBitsInt |= (1<<curPos);
+				curSpecBitsInt |= ((uint64_t)1<<curPos);
 				if (c=='1') {
-					curOutputInt |= (1<<curPos);
+					curOutputInt |= ((uint64_t)1<<curPos);
 				}
 			} else {
 				fullySpecified = false;
 			}
-			if (i/(sizeof(int)*8) == vecLength-1) {
+			if (i/WORD_BITS == vecLength-1) {
 				lastMask = (lastMask<<1)|1;
 			}
 		}
 	}
 
+	//seqWords and specWords contain (seqLength-1)/WORD_BITS+1 words each, in the format of seq and specifiedBits
+	void init(unsigned int length, const uint64_t* seqWords, const uint64_t* specWords) {
+		id = -1;
+		seqLength = length;
+		unsigned int vecLength = (seqLength-1)/WORD_BITS +1;
+
+		seq.resize(vecLength, 0);
+		specifiedBits.resize(vecLength, 0);
+		memcpy(seq.data(), seqWords, vecLength*sizeof(uint64_t));
+		memcpy(specifiedBits.data(), specWords, vecLength*sizeof(uint64_t));
+
+		unsigned int lastBits = seqLength - (vecLength-1)*WORD_BITS;
+		lastMask = (lastBits==WORD_BITS) ? ~(uint64_t)0 : (((uint64_t)1<<lastBits) - 1);
+
+		fullySpecified = true;
+		for (unsigned int i=0; i<vecLength; i++) {
+			uint64_t mask = (i==vecLength-1) ? lastMask : ~(uint64_t)0;
+			if ((specifiedBits[i]&mask) != mask) fullySpecified = false;
+		}
+	}
+
 	//bits that are specified in both outputs must be the same
 	bool isCompatible(const IncSpecSeq& other) const {
+		if (seq.size() >= KERNEL_MIN_WORDS) {
+			return !seqConflict(seq.data(), specifiedBits.data(), other.seq.data(), other.specifiedBits.data(), seq.size());
+		}
+
+		const uint64_t* s1 = seq.data();
+		const uint64_t* s2 = other.seq.data();
+		const uint64_t* b1 = specifiedBits.data();
+		const uint64_t* b2 = other.specifiedBits.data();
 		for (unsigned int i=0; i<specifiedBits.size(); i++) {
-			unsigned int mask = specifiedBits[i] & other.specifiedBits[i];
-			unsigned int spec1 = (seq[i] & mask);
-			unsigned int spec2 = (other.seq[i] & mask);
-			if (spec1!=spec2) return false;
+			if ((s1[i]^s2[i]) & b1[i] & b2[i]) return false;
 		}
 		return true;
 	}
@@ -90,9 +226,7 @@ public:
 		ret.lastMask = lastMask;
 		ret.fullySpecified = fullySpecified || other.fullySpecified;
 
-		ret.seq.clear();
 		ret.seq.resize(seq.size(), 0);
-		ret.specifiedBits.clear();
 		ret.specifiedBits.resize(specifiedBits.size(), 0);
 
 		for (unsigned int i=0; i<seq.size(); i++) {
@@ -105,9 +239,16 @@ public:
 
 	//two sequences are disjoint if their intersection is empty
 	bool isDisjoint(const IncSpecSeq& other) const {
+		if (seq.size() >= KERNEL_MIN_WORDS) {
+			return seqConflict(seq.data(), specifiedBits.data(), other.seq.data(), other.specifiedBits.data(), seq.size());
+		}
+
+		const uint64_t* s1 = seq.data();
+		const uint64_t* s2 = other.seq.data();
+		const uint64_t* b1 = specifiedBits.data();
+		const uint64_t* b2 = other.specifiedBits.data();
 		for (unsigned int i=0; i<seq.size(); i++) {
-			unsigned int mask = specifiedBits[i] & other.specifiedBits[i];
-			if ((seq[i]&mask) != (other.seq[i]&mask)) return true;
+			if ((s1[i]^s2[i]) & b1[i] & b2[i]) return true;
 		}
 		return false;
 	}
@@ -119,16 +260,16 @@ public:
 
 		IncSpecSeq last = *this;
 		for (unsigned int i=0; i<seq.size(); i++) {
-			for (unsigned int b=0; b<(sizeof(int)*8); b++) {
-				if (i*(sizeof(int)*8)+b>=seqLength) break;
+			for (unsigned int b=0; b<WORD_BITS; b++) {
+				if (i*WORD_BITS+b>=seqLength) break;
 
 				if (!((specifiedBits[i]>>b)&1) && ((other.specifiedBits[i]>>b)&1)) {
 					IncSpecSeq newSeq=last;
-					unsigned int otherBitNew = ((~other.seq[i])>>b)&1;
-					unsigned int otherBitLast = (other.seq[i]>>b)&1;
+					uint64_t otherBitNew = ((~other.seq[i])>>b)&1;
+					uint64_t otherBitLast = (other.seq[i]>>b)&1;
 
-					newSeq.specifiedBits[i] |= (1<<b);
-					last.specifiedBits[i] |= (1<<b);
+					newSeq.specifiedBits[i] |= ((uint64_t)1<<b);
+					last.specifiedBits[i] |= ((uint64_t)1<<b);
 
 					newSeq.seq[i] |= (otherBitNew<<b);
 					last.seq[i] |= (otherBitLast<<b);
@@ -144,6 +285,10 @@ public:
 	//if a bit of this seq is unspecified, the corresponding bit of the other seq must also be unspecified
 	//all specified bits must be equal
 	bool isSubset(const IncSpecSeq& other) const {
+		if (seq.size() >= KERNEL_MIN_WORDS) {
+			return specContains(specifiedBits.data(), other.specifiedBits.data(), seq.size()) && isCompatible(other);
+		}
+
 		for (unsigned int i=0; i<seq.size(); i++) {
 			if ((other.specifiedBits[i]&specifiedBits[i])!=other.specifiedBits[i]) {
 				return false;
@@ -179,11 +324,11 @@ public:
 		string s;
 		s.reserve(seqLength);
 		for (unsigned int i=0; i<seqLength; i++) {
-			int curPos = i%(sizeof(int)*8);
-			if (((specifiedBits[i/(sizeof(int)*8)]>>curPos)&1)==0) {
+			int curPos = i%WORD_BITS;
+			if (((specifiedBits[i/WORD_BITS]>>curPos)&1)==0) {
 				s.push_back('-');
 			} else {
-				s.push_back(((seq[i/(sizeof(int)*8)]>>curPos)&1)+'0');
+				s.push_back(((seq[i/WORD_BITS]>>curPos)&1)+'0');
 			}
 		}
 		return s;
@@ -197,11 +342,11 @@ public:
 		CString = new char[seqLength+1];
 		CString[seqLength] = '\0';
 		for (unsigned int i=0; i<seqLength; i++) {
-			int curPos = i%(sizeof(int)*8);
-			if (((specifiedBits[i/(sizeof(int)*8)]>>curPos)&1)==0) {
+			int curPos = i%WORD_BITS;
+			if (((specifiedBits[i/WORD_BITS]>>curPos)&1)==0) {
 				CString[i] = '-';
 			} else {
-				CString[i] = (((seq[i/(sizeof(int)*8)]>>curPos)&1)+'0');
+				CString[i] = (((seq[i/WORD_BITS]>>curPos)&1)+'0');
 			}
 		}
 		return CString;
@@ -215,8 +360,9 @@ namespace std {
 template<> struct hash<IncSpecSeq> {
 	std::size_t operator()(const IncSpecSeq& k) const {
 		std::size_t seed = 0;
-		for (auto& i : k.seq) {
-			seed ^= i + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		for (unsigned int i=0; i<k.seq.size(); i++) {
+			seed ^= k.seq[i] + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			seed ^= k.specifiedBits[i] + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 		}
 		return seed;
 	}
@@ -0,0 +1,102 @@
+/*
+ * IncSpecSeqKernels.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "IncSpecSeqKernels.h"
+
+#ifdef INCSPECSEQ_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+bool seqConflictScalar(const uint64_t* seq1, const uint64_t* spec1, const uint64_t* seq2, const uint64_t* spec2, unsigned int nWords) {
+	for (unsigned int i=0; i<nWords; i++) {
+		if ((seq1[i]^seq2[i]) & spec1[i] & spec2[i]) return true;
+	}
+	return false;
+}
+
+bool specContainsScalar(const uint64_t* spec1, const uint64_t* spec2, unsigned int nWords) {
+	for (unsigned int i=0; i<nWords; i++) {
+		if (spec2[i] & ~spec1[i]) return false;
+	}
+	return true;
+}
+
+#ifdef INCSPECSEQ_X86_KERNELS
+
+__attribute__((target("sse2")))
+bool seqConflictSSE2(const uint64_t* seq1, const uint64_t* spec1, const uint64_t* seq2, const uint64_t* spec2, unsigned int nWords) {
+	const __m128i zero = _mm_setzero_si128();
+	unsigned int i=0;
+	for (; i+2<=nWords; i+=2) {
+		__m128i diff = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(seq1+i)), _mm_loadu_si128((const __m128i*)(seq2+i)));
+		__m128i mask = _mm_and_si128(_mm_loadu_si128((const __m128i*)(spec1+i)), _mm_loadu_si128((const __m128i*)(spec2+i)));
+		__m128i conflict = _mm_and_si128(diff, mask);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(conflict, zero)) != 0xFFFF) return true;
+	}
+	return seqConflictScalar(seq1+i, spec1+i, seq2+i, spec2+i, nWords-i);
+}
+
+__attribute__((target("sse2")))
+bool specContainsSSE2(const uint64_t* spec1, const uint64_t* spec2, unsigned int nWords) {
+	const __m128i zero = _mm_setzero_si128();
+	unsigned int i=0;
+	for (; i+2<=nWords; i+=2) {
+		__m128i missing = _mm_andnot_si128(_mm_loadu_si128((const __m128i*)(spec1+i)), _mm_loadu_si128((const __m128i*)(spec2+i)));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(missing, zero)) != 0xFFFF) return false;
+	}
+	return specContainsScalar(spec1+i, spec2+i, nWords-i);
+}
+
+__attribute__((target("avx2")))
+bool seqConflictAVX2(const uint64_t* seq1, const uint64_t* spec1, const uint64_t* seq2, const uint64_t* spec2, unsigned int nWords) {
+	unsigned int i=0;
+	for (; i+4<=nWords; i+=4) {
+		__m256i diff = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(seq1+i)), _mm256_loadu_si256((const __m256i*)(seq2+i)));
+		__m256i mask = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(spec1+i)), _mm256_loadu_si256((const __m256i*)(spec2+i)));
+		if (!_mm256_testz_si256(diff, mask)) return true;
+	}
+	return seqConflictScalar(seq1+i, spec1+i, seq2+i, spec2+i, nWords-i);
+}
+
+__attribute__((target("avx2")))
+bool specContainsAVX2(const uint64_t* spec1, const uint64_t* spec2, unsigned int nWords) {
+	unsigned int i=0;
+	for (; i+4<=nWords; i+=4) {
+		//testc returns 1 iff (~spec1 & spec2) is 0
+		if (!_mm256_testc_si256(_mm256_loadu_si256((const __m256i*)(spec1+i)), _mm256_loadu_si256((const __m256i*)(spec2+i)))) return false;
+	}
+	return specContainsScalar(spec1+i, spec2+i, nWords-i);
+}
+
+static bool cpuSupportsAVX2() {
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+}
+
+static bool cpuSupportsSSE2() {
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("sse2");
+}
+
+SeqConflictKernel seqConflict = cpuSupportsAVX2() ? seqConflictAVX2 : (cpuSupportsSSE2() ? seqConflictSSE2 : seqConflictScalar);
+SpecContainsKernel specContains = cpuSupportsAVX2() ? specContainsAVX2 : (cpuSupportsSSE2() ? specContainsSSE2 : specContainsScalar);
+
+const char* seqKernelName() {
+	if (seqConflict == seqConflictAVX2) return "AVX2";
+	if (seqConflict == seqConflictSSE2) return "SSE2";
+	return "scalar";
+}
+
+#else
+
+SeqConflictKernel seqConflict = seqConflictScalar;
+SpecContainsKernel specContains = specContainsScalar;
+
+const char* seqKernelName() {
+	return "scalar";
+}
+
+#endif
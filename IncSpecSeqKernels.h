@@ -0,0 +1,39 @@
+/*
+ * IncSpecSeqKernels.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef INCSPECSEQKERNELS_H_
+#define INCSPECSEQKERNELS_H_
+
+#include <stdint.h>
+
+//kernels for comparing the words of two incompletely specified sequences (see IncSpecSeq);
+//seq contains the values of the bits, spec is 1 for the specified bits
+
+//returns true iff there is a bit that is specified in both sequences and has different values
+typedef bool (*SeqConflictKernel)(const uint64_t* seq1, const uint64_t* spec1, const uint64_t* seq2, const uint64_t* spec2, unsigned int nWords);
+
+//returns true iff every bit that is specified in spec2 is also specified in spec1
+typedef bool (*SpecContainsKernel)(const uint64_t* spec1, const uint64_t* spec2, unsigned int nWords);
+
+bool seqConflictScalar(const uint64_t* seq1, const uint64_t* spec1, const uint64_t* seq2, const uint64_t* spec2, unsigned int nWords);
+bool specContainsScalar(const uint64_t* spec1, const uint64_t* spec2, unsigned int nWords);
+
+#if defined(__x86_64__) || defined(__i386__)
+#define INCSPECSEQ_X86_KERNELS
+bool seqConflictSSE2(const uint64_t* seq1, const uint64_t* spec1, const uint64_t* seq2, const uint64_t* spec2, unsigned int nWords);
+bool specContainsSSE2(const uint64_t* spec1, const uint64_t* spec2, unsigned int nWords);
+bool seqConflictAVX2(const uint64_t* seq1, const uint64_t* spec1, const uint64_t* seq2, const uint64_t* spec2, unsigned int nWords);
+bool specContainsAVX2(const uint64_t* spec1, const uint64_t* spec2, unsigned int nWords);
+#endif
+
+//the best kernels that are supported by the CPU (selected at startup)
+extern SeqConflictKernel seqConflict;
+extern SpecContainsKernel specContains;
+
+//name of the instruction set of the selected kernels
+const char* seqKernelName();
+
+#endif /* INCSPECSEQKERNELS_H_ */
@@ -6,121 +6,237 @@
  */
 #include "KISSParser.h"
 #include <cstdlib>
-#include <fstream>
+#include <cstring>
 #include <vector>
-#include <map>
-#include <queue>
-#include <set>
-#include <sstream>
 #include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
 
 #include "global.h"
 
 using std::string;
 using std::cout;
+using std::endl;
 using std::vector;
-using std::map;
 using std::unordered_map;
-using std::set;
-using std::queue;
 using std::pair;
 using std::make_pair;
 
-void parseKISSFile(string filename, vector<vector<pair<IncSpecSeq*,pair<int, IncSpecSeq*> > > >& states, int& resetState, int& numInputBits, int& numOutputBits) {
-	resetState=-1;
-	std::ifstream myfile(filename.c_str());
-
-	unordered_map<string, int> stateToInt;
-	unordered_map<string, IncSpecSeq*> stringToIncSpecSeq;
-
-	if (myfile.is_open()) {
-		string line;
-
-		vector<pair<IncSpecSeq*,pair<int, IncSpecSeq*> > > undefinedFromStates;
-
-		while (getline(myfile, line)) {
-			if (line[0]=='.') {
-				if (line[1]=='r') {
-					string resetStateStr = line.substr(3, line.find_last_not_of(" \t\f\v\n\r")-2);
-
-					if (stateToInt.count(resetStateStr)==0) {
-						stateToInt[resetStateStr] = states.size();
-						states.resize(states.size()+1);
-					}
-					resetState = stateToInt[resetStateStr];
-				} else if (line[1]=='i') {
-					string inputStr = line.substr(3, line.find_last_not_of(" \t\f\v\n\r")-2);
-					std::istringstream(inputStr) >> numInputBits;
-				} else if (line[1]=='o') {
-					string outputStr = line.substr(3, line.find_last_not_of(" \t\f\v\n\r")-2);
-					std::istringstream(outputStr) >> numOutputBits;
-				}
-			} else if (line[0]=='0' || line[0]=='1' || line[0]=='-') {
-				unsigned int startIndex = 0;
-				unsigned int nextSplit = line.find_first_not_of("01-");
-				string inputStr = line.substr(startIndex, nextSplit);
-
-				startIndex = line.find_first_not_of(" \t\f\v\n\r", nextSplit);
-				nextSplit = line.find_first_of(" \t\f\v\n\r", startIndex);
-				string fromState = line.substr(startIndex, nextSplit-startIndex);
-
-				startIndex = line.find_first_not_of(" \t\f\v\n\r", nextSplit);
-				nextSplit = line.find_first_of(" \t\f\v\n\r", startIndex);
-				string toState = line.substr(startIndex, nextSplit-startIndex);
-
-				startIndex = line.find_first_not_of(" \t\f\v\n\r", nextSplit);
-				nextSplit = line.find_first_not_of("01-", startIndex);
-				if (nextSplit==string::npos) nextSplit = line.length();
-				string outputStr = line.substr(startIndex, nextSplit-startIndex);
-
-				if (stringToIncSpecSeq.count(inputStr)==0) {
-					stringToIncSpecSeq[inputStr] = new IncSpecSeq(inputStr);
-				}
-
-				if (stringToIncSpecSeq.count(outputStr)==0) {
-					stringToIncSpecSeq[outputStr] = new IncSpecSeq(outputStr);
-				}
-
-				IncSpecSeq* input = stringToIncSpecSeq[inputStr];
-				IncSpecSeq* output = stringToIncSpecSeq[outputStr];
-
-				if (fromState!="*" && stateToInt.count(fromState)==0) {
-					stateToInt[fromState] = states.size();
-					states.resize(states.size()+1);
-					if (resetState==-1 && firstStateReset) resetState=stateToInt[fromState];
-				}
-
-				if (stateToInt.count(toState)==0) {
-					stateToInt[toState] = states.size();
-					states.resize(states.size()+1);
-					if (resetState==-1 && firstStateReset && toState!="*") resetState=stateToInt[toState];
-				}
-
-
-				if (fromState=="*") {
-					undefinedFromStates.push_back(make_pair(input, make_pair(stateToInt[toState], output)));
-					continue;
-				}
-
-				int fromStateI = stateToInt[fromState];
-				int toStateI = stateToInt[toState];
-
-				vector<pair<IncSpecSeq*,pair<int, IncSpecSeq*> > >& curMap = states[fromStateI];
-				curMap.push_back(make_pair(input, make_pair(toStateI, output)));
-			}
+//part of the input file; the file is not copied, so slices are only valid as long as the file is mapped
+struct StrSlice {
+	const char* begin;
+	size_t length;
+
+	StrSlice() : begin(NULL), length(0) {
+	}
+
+	StrSlice(const char* begin, size_t length) : begin(begin), length(length) {
+	}
+
+	bool operator==(const StrSlice& other) const {
+		return length==other.length && memcmp(begin, other.begin, length)==0;
+	}
+
+	bool equals(const char* s) const {
+		return length==strlen(s) && memcmp(begin, s, length)==0;
+	}
+};
+
+//FNV-1a
+struct StrSliceHash {
+	std::size_t operator()(const StrSlice& k) const {
+		std::size_t hash = 14695981039346656037ULL;
+		for (size_t i=0; i<k.length; i++) {
+			hash ^= (unsigned char)k.begin[i];
+			hash *= 1099511628211ULL;
 		}
+		return hash;
+	}
+};
+
+inline bool isWhitespace(char c) {
+	return c==' ' || c=='\t' || c=='\f' || c=='\v' || c=='\n' || c=='\r';
+}
+
+inline bool isSeqChar(char c) {
+	return c=='0' || c=='1' || c=='-';
+}
+
+//contents of the input file; the file is memory-mapped if possible, otherwise it is read into a buffer
+class InputFile {
+public:
+	const char* data;
+	size_t size;
+
+	InputFile() : data(NULL), size(0), mapped(false) {
+	}
 
-		for (vector<pair<IncSpecSeq*,pair<int, IncSpecSeq*> > >::iterator it=undefinedFromStates.begin(); it!=undefinedFromStates.end(); it++) {
-			pair<IncSpecSeq*,pair<int, IncSpecSeq*> >& p = *it;
-			IncSpecSeq* input = p.first;
-			for (unsigned int s=0; s<states.size(); s++) {
-				states[s].push_back(make_pair(input, p.second));
+	~InputFile() {
+		if (mapped) munmap((void*)data, size);
+	}
+
+	bool open(const string& filename) {
+		int fd = ::open(filename.c_str(), O_RDONLY);
+		if (fd<0) return false;
+
+		struct stat st;
+		if (fstat(fd, &st)==0 && S_ISREG(st.st_mode) && st.st_size>0) {
+			void* mem = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mem!=MAP_FAILED) {
+				madvise(mem, st.st_size, MADV_SEQUENTIAL);
+				data = (const char*)mem;
+				size = st.st_size;
+				mapped = true;
+				close(fd);
+				return true;
 			}
 		}
 
-		myfile.close();
-	} else {
+		char buf[1<<16];
+		ssize_t n;
+		while ((n = read(fd, buf, sizeof(buf))) > 0) {
+			buffer.insert(buffer.end(), buf, buf+n);
+		}
+		close(fd);
+		data = buffer.empty() ? NULL : &buffer[0];
+		size = buffer.size();
+		return n==0;
+	}
+
+private:
+	bool mapped;
+	vector<char> buffer;
+};
+
+//returns the state with the given name; a new state is created if there is no such state yet
+inline int getState(StrSlice name, unordered_map<StrSlice, int, StrSliceHash>& stateToInt, vector<vector<pair<IncSpecSeq*,pair<int, IncSpecSeq*> > > >& states, bool& created) {
+	pair<unordered_map<StrSlice, int, StrSliceHash>::iterator, bool> ins = stateToInt.insert(make_pair(name, (int)states.size()));
+	created = ins.second;
+	if (created) states.resize(states.size()+1);
+	return ins.first->second;
+}
+
+inline IncSpecSeq* getIncSpecSeq(StrSlice str, unordered_map<StrSlice, IncSpecSeq*, StrSliceHash>& stringToIncSpecSeq) {
+	pair<unordered_map<StrSlice, IncSpecSeq*, StrSliceHash>::iterator, bool> ins = stringToIncSpecSeq.insert(make_pair(str, (IncSpecSeq*)NULL));
+	if (ins.second) ins.first->second = new IncSpecSeq(str.begin, str.length);
+	return ins.first->second;
+}
+
+inline int parseInt(const char* pos, const char* lineEnd) {
+	while (pos<lineEnd && isWhitespace(*pos)) pos++;
+	int ret = 0;
+	while (pos<lineEnd && *pos>='0' && *pos<='9') {
+		ret = 10*ret + (*pos-'0');
+		pos++;
+	}
+	return ret;
+}
+
+//next whitespace-separated token in [pos, lineEnd); pos is moved behind the token
+inline StrSlice nextToken(const char*& pos, const char* lineEnd) {
+	while (pos<lineEnd && isWhitespace(*pos)) pos++;
+	const char* start = pos;
+	while (pos<lineEnd && !isWhitespace(*pos)) pos++;
+	return StrSlice(start, pos-start);
+}
+
+//next sequence of '0', '1', and '-' characters (after optional whitespace); pos is moved behind the sequence
+inline StrSlice nextSeq(const char*& pos, const char* lineEnd) {
+	while (pos<lineEnd && isWhitespace(*pos)) pos++;
+	const char* start = pos;
+	while (pos<lineEnd && isSeqChar(*pos)) pos++;
+	return StrSlice(start, pos-start);
+}
+
+void parseKISSFile(string filename, vector<vector<pair<IncSpecSeq*,pair<int, IncSpecSeq*> > > >& states, vector<IncSpecSeq*>& inputs, int& resetState, int& numInputBits, int& numOutputBits) {
+	timeval start, end;
+	gettimeofday(&start, 0);
+
+	resetState=-1;
+
+	InputFile file;
+	if (!file.open(filename)) {
 		std::cerr << "Unable to open file "<<filename << std::endl;
 		exit(1);
 	}
+
+	unordered_map<StrSlice, int, StrSliceHash> stateToInt;
+	unordered_map<StrSlice, IncSpecSeq*, StrSliceHash> stringToIncSpecSeq;
+
+	vector<pair<IncSpecSeq*,pair<int, IncSpecSeq*> > > undefinedFromStates;
+
+	const char* fileEnd = file.data + file.size;
+	int lineNumber = 0;
+	bool created;
+
+	for (const char* line = file.data; line<fileEnd; ) {
+		const char* lineEnd = (const char*)memchr(line, '\n', fileEnd-line);
+		if (lineEnd==NULL) lineEnd = fileEnd;
+		lineNumber++;
+
+		if (line[0]=='.' && lineEnd-line>1) {
+			if (line[1]=='r') {
+				const char* pos = line+2;
+				StrSlice resetStateStr = nextToken(pos, lineEnd);
+				resetState = getState(resetStateStr, stateToInt, states, created);
+			} else if (line[1]=='i') {
+				numInputBits = parseInt(line+2, lineEnd);
+			} else if (line[1]=='o') {
+				numOutputBits = parseInt(line+2, lineEnd);
+			}
+		} else if (isSeqChar(line[0])) {
+			const char* pos = line;
+			StrSlice inputStr = nextSeq(pos, lineEnd);
+			StrSlice fromState = nextToken(pos, lineEnd);
+			StrSlice toState = nextToken(pos, lineEnd);
+			StrSlice outputStr = nextSeq(pos, lineEnd);
+
+			if (toState.length==0 || outputStr.length==0) {
+				std::cerr << "Invalid transition in line " << lineNumber << " of " << filename << std::endl;
+				exit(1);
+			}
+
+			IncSpecSeq* input = getIncSpecSeq(inputStr, stringToIncSpecSeq);
+			IncSpecSeq* output = getIncSpecSeq(outputStr, stringToIncSpecSeq);
+
+			if (input->id==-1) {
+				input->id = inputs.size();
+				inputs.push_back(input);
+			}
+
+			bool fromStateUndefined = fromState.equals("*");
+
+			int fromStateI = -1;
+			if (!fromStateUndefined) {
+				fromStateI = getState(fromState, stateToInt, states, created);
+				if (created && resetState==-1 && firstStateReset) resetState=fromStateI;
+			}
+
+			int toStateI = getState(toState, stateToInt, states, created);
+			if (created && resetState==-1 && firstStateReset && !toState.equals("*")) resetState=toStateI;
+
+			if (fromStateUndefined) {
+				undefinedFromStates.push_back(make_pair(input, make_pair(toStateI, output)));
+			} else {
+				states[fromStateI].push_back(make_pair(input, make_pair(toStateI, output)));
+			}
+		}
+
+		line = lineEnd+1;
+	}
+
+	for (vector<pair<IncSpecSeq*,pair<int, IncSpecSeq*> > >::iterator it=undefinedFromStates.begin(); it!=undefinedFromStates.end(); it++) {
+		pair<IncSpecSeq*,pair<int, IncSpecSeq*> >& p = *it;
+		IncSpecSeq* input = p.first;
+		for (unsigned int s=0; s<states.size(); s++) {
+			states[s].push_back(make_pair(input, p.second));
+		}
+	}
+
+	gettimeofday(&end, 0);
+	double usec = (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec);
+	if (verbosity>0) cout << "Parsing throughput: " << file.size << " bytes, " << (usec>0 ? file.size/usec : 0) << " MB/s" << endl;
 }
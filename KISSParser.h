@@ -16,6 +16,7 @@
 
 #include "IncSpecSeq.h"
 
-void parseKISSFile(std::string filename, std::vector<std::vector<std::pair<IncSpecSeq*,std::pair<int, IncSpecSeq*> > > >& states, int& resetState, int& numInputBits, int& numOutputBits);
+//inputs[i] is the (interned) input with id i
+void parseKISSFile(std::string filename, std::vector<std::vector<std::pair<IncSpecSeq*,std::pair<int, IncSpecSeq*> > > >& states, std::vector<IncSpecSeq*>& inputs, int& resetState, int& numInputBits, int& numOutputBits);
 
 #endif /* KISSPARSER_H_ */
@@ -0,0 +1,295 @@
+/*
+ * MaxClique.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+#include "MaxClique.h"
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <sys/time.h>
+
+using std::vector;
+
+//the vertices are renumbered such that vertices with a high degree come first; all bitsets use the new numbering
+class MaxCliqueSearch {
+public:
+	MaxCliqueSearch(BitMatrix& graph, vector<int>& initialClique, double timeLimit) : nNodes(0), timedOut(false) {
+		nVertices = graph.rows();
+		nWords = BitMatrix::wordsForBits(nVertices);
+
+		vector<unsigned int> degree(nVertices);
+		order.resize(nVertices);
+		for (unsigned int v=0; v<nVertices; v++) {
+			degree[v] = graph.countRow(v);
+			order[v] = v;
+		}
+		HigherDegree comp;
+		comp.degree = &degree;
+		std::stable_sort(order.begin(), order.end(), comp);
+
+		vector<int> newNumber(nVertices);
+		for (unsigned int i=0; i<nVertices; i++) newNumber[order[i]] = i;
+
+		//the diagonal is not copied (a state can be incompatible with itself, but it can only be once in a clique)
+		adj.resize(nVertices, nVertices);
+		for (unsigned int i=0; i<nVertices; i++) {
+			int v = order[i];
+			for (int w=graph.nextSetBit(v, 0); w!=-1; w=graph.nextSetBit(v, w+1)) {
+				if (w != v) adj.set(i, newNumber[w]);
+			}
+		}
+
+		for (unsigned int i=0; i<initialClique.size(); i++) best.push_back(newNumber[initialClique[i]]);
+
+		timeval now;
+		gettimeofday(&now, 0);
+		deadline = now.tv_sec + now.tv_usec/1e6 + timeLimit;
+	}
+
+	//returns true if the search was completed
+	bool run() {
+		vector<uint64_t> candidates(nWords);
+		BitMatrix::setFirstBits(candidates.data(), nVertices);
+		vector<int> current;
+		expand(current, candidates);
+		return !timedOut;
+	}
+
+	//the largest clique that was found (in the original numbering)
+	void getClique(vector<int>& clique) {
+		clique.clear();
+		for (unsigned int i=0; i<best.size(); i++) clique.push_back(order[best[i]]);
+	}
+
+private:
+	unsigned int nVertices;
+	unsigned int nWords;
+	//order[i] is the original number of vertex i
+	vector<int> order;
+	BitMatrix adj;
+
+	vector<int> best;
+
+	unsigned long long nNodes;
+	double deadline;
+	bool timedOut;
+
+	struct HigherDegree {
+		vector<unsigned int>* degree;
+		bool operator()(int v1, int v2) const {
+			return (*degree)[v1] > (*degree)[v2];
+		}
+	};
+
+	bool checkTime() {
+		if ((++nNodes & 1023) == 0) {
+			timeval now;
+			gettimeofday(&now, 0);
+			if (now.tv_sec + now.tv_usec/1e6 > deadline) timedOut = true;
+		}
+		return !timedOut;
+	}
+
+	//greedy sequential coloring of the candidates; vertices[i] has color colors[i], and colors are non-decreasing
+	void color(const vector<uint64_t>& candidates, vector<int>& vertices, vector<int>& colors) {
+		vector<uint64_t> uncolored(candidates);
+		vector<uint64_t> available(nWords);
+		int curColor = 0;
+		bool empty = false;
+		while (!empty) {
+			curColor++;
+			available = uncolored;
+			//all vertices of the same color are pairwise non-adjacent
+			for (int v=BitMatrix::nextSetBit(available.data(), nVertices, 0); v!=-1; v=BitMatrix::nextSetBit(available.data(), nVertices, v+1)) {
+				adj.andNotRow(v, available.data());
+				uncolored[v/64] &= ~((uint64_t)1 << (v%64));
+				vertices.push_back(v);
+				colors.push_back(curColor);
+			}
+			empty = true;
+			for (unsigned int i=0; i<nWords; i++) {
+				if (uncolored[i]) {
+					empty = false;
+					break;
+				}
+			}
+		}
+	}
+
+	void expand(vector<int>& current, vector<uint64_t>& candidates) {
+		if (!checkTime()) return;
+
+		vector<int> vertices;
+		vector<int> colors;
+		color(candidates, vertices, colors);
+
+		vector<uint64_t> newCandidates(nWords);
+		for (int i=vertices.size()-1; i>=0; i--) {
+			//the candidates at positions <= i can be colored with colors[i] colors, so they contain no clique with more than colors[i] vertices
+			if (current.size() + colors[i] <= best.size()) return;
+
+			int v = vertices[i];
+			current.push_back(v);
+
+			bool empty = true;
+			const uint64_t* row = adj.row(v);
+			for (unsigned int w=0; w<nWords; w++) {
+				newCandidates[w] = candidates[w] & row[w];
+				if (newCandidates[w]) empty = false;
+			}
+
+			if (empty) {
+				if (current.size() > best.size()) best = current;
+			} else {
+				expand(current, newCandidates);
+			}
+
+			current.pop_back();
+			candidates[v/64] &= ~((uint64_t)1 << (v%64));
+			if (timedOut) return;
+		}
+	}
+};
+
+bool findMaxClique(BitMatrix& graph, vector<int>& clique, double timeLimit) {
+	MaxCliqueSearch search(graph, clique, timeLimit);
+	bool completed = search.run();
+	search.getClique(clique);
+	return completed;
+}
+
+//state shared by the threads of the multi-start search; best is protected by mutex
+struct MultiStartSearch {
+	BitMatrix* graph;
+	double deadline;
+	std::mutex mutex;
+	vector<int> best;
+};
+
+//local search for one thread
+class CliqueLocalSearch {
+public:
+	CliqueLocalSearch(MultiStartSearch* search, unsigned int seed) : search(search), graph(*search->graph), rng(seed) {
+		nVertices = graph.rows();
+		nWords = BitMatrix::wordsForBits(nVertices);
+		candidates.resize(nWords);
+	}
+
+	void run() {
+		//number of local search steps without improvement after which the search is restarted
+		const unsigned int MAX_STEPS_WITHOUT_IMPROVEMENT = 100;
+
+		while (!timeUp()) {
+			vector<int> clique;
+			extend(clique, -1);
+			vector<int> restartBest = clique;
+			publish(clique);
+
+			for (unsigned int steps=0; steps<MAX_STEPS_WITHOUT_IMPROVEMENT && !clique.empty(); steps++) {
+				if ((steps&15)==0 && timeUp()) return;
+
+				//remove a random vertex, and extend the clique again without it (if only one vertex is added, this is a swap move)
+				vector<int> newClique = clique;
+				unsigned int removeI = rng() % newClique.size();
+				int removed = newClique[removeI];
+				newClique[removeI] = newClique.back();
+				newClique.pop_back();
+				extend(newClique, removed);
+
+				if (newClique.size() >= clique.size()) clique.swap(newClique);
+				if (clique.size() > restartBest.size()) {
+					restartBest = clique;
+					publish(clique);
+					steps = 0;
+				}
+			}
+		}
+	}
+
+private:
+	MultiStartSearch* search;
+	BitMatrix& graph;
+	std::mt19937 rng;
+	unsigned int nVertices;
+	unsigned int nWords;
+	vector<uint64_t> candidates;
+
+	bool timeUp() {
+		timeval now;
+		gettimeofday(&now, 0);
+		return now.tv_sec + now.tv_usec/1e6 > search->deadline;
+	}
+
+	void publish(vector<int>& clique) {
+		std::lock_guard<std::mutex> lock(search->mutex);
+		if (clique.size() > search->best.size()) search->best = clique;
+	}
+
+	//extends the clique greedily; excluded (if not -1) is not added
+	//in each step, a candidate with the most neighbors among the candidates is added (ties are broken randomly)
+	void extend(vector<int>& clique, int excluded) {
+		BitMatrix::setFirstBits(candidates.data(), nVertices);
+		for (unsigned int i=0; i<clique.size(); i++) {
+			graph.andRow(clique[i], candidates.data());
+			candidates[clique[i]/64] &= ~((uint64_t)1 << (clique[i]%64));
+		}
+		if (excluded != -1) candidates[excluded/64] &= ~((uint64_t)1 << (excluded%64));
+
+		for (unsigned int steps=1; ; steps++) {
+			if ((steps&63)==0 && timeUp()) return;
+
+			int bestV = -1;
+			unsigned int bestDegree = 0;
+			unsigned int nTies = 0;
+			for (int v=BitMatrix::nextSetBit(candidates.data(), nVertices, 0); v!=-1; v=BitMatrix::nextSetBit(candidates.data(), nVertices, v+1)) {
+				const uint64_t* row = graph.row(v);
+				unsigned int degree = 0;
+				for (unsigned int w=0; w<nWords; w++) degree += __builtin_popcountll(candidates[w] & row[w]);
+
+				if (bestV==-1 || degree > bestDegree) {
+					bestV = v;
+					bestDegree = degree;
+					nTies = 1;
+				} else if (degree == bestDegree && rng() % (++nTies) == 0) {
+					bestV = v;
+				}
+			}
+			if (bestV == -1) return;
+
+			clique.push_back(bestV);
+			graph.andRow(bestV, candidates.data());
+			candidates[bestV/64] &= ~((uint64_t)1 << (bestV%64));
+		}
+	}
+};
+
+void multiStartWorker(MultiStartSearch* search, unsigned int seed) {
+	CliqueLocalSearch localSearch(search, seed);
+	localSearch.run();
+}
+
+void findCliqueMultiStart(BitMatrix& graph, vector<int>& clique, double timeLimit, int nThreads) {
+	//a state can be incompatible with itself, but it can only be once in a clique
+	BitMatrix irreflexiveGraph(graph);
+	for (unsigned int v=0; v<graph.rows(); v++) irreflexiveGraph.reset(v, v);
+
+	MultiStartSearch search;
+	search.graph = &irreflexiveGraph;
+	search.best = clique;
+
+	timeval now;
+	gettimeofday(&now, 0);
+	search.deadline = now.tv_sec + now.tv_usec/1e6 + timeLimit;
+
+	vector<std::thread> threads;
+	for (int t=0; t<nThreads; t++) {
+		threads.push_back(std::thread(multiStartWorker, &search, t+1));
+	}
+	for (unsigned int t=0; t<threads.size(); t++) {
+		threads[t].join();
+	}
+
+	clique = search.best;
+}
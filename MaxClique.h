@@ -0,0 +1,25 @@
+/*
+ * MaxClique.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef MAXCLIQUE_H_
+#define MAXCLIQUE_H_
+
+#include <vector>
+
+#include "BitMatrix.h"
+
+//searches for a maximum clique in the graph with the (symmetric) adjacency matrix graph (its diagonal is ignored), using branch and bound with greedy coloring bounds on bitsets (BBMC)
+//clique must contain an initial clique (e.g., from a heuristic); it is replaced whenever a larger clique is found
+//the search is stopped after timeLimit seconds; returns true if the search was completed, i.e., if clique is a maximum clique
+bool findMaxClique(BitMatrix& graph, std::vector<int>& clique, double timeLimit);
+
+//heuristic search for a large clique on nThreads threads: each thread repeatedly builds a clique greedily (with random tie-breaking),
+//and improves it by local search (a random vertex of the clique is removed, and the clique is extended greedily again)
+//clique must contain an initial clique; it is replaced whenever a larger clique is found; the search is stopped after timeLimit seconds
+//like in findMaxClique, the diagonal of graph is ignored
+void findCliqueMultiStart(BitMatrix& graph, std::vector<int>& clique, double timeLimit, int nThreads);
+
+#endif /* MAXCLIQUE_H_ */
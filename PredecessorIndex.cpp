@@ -0,0 +1,90 @@
+/*
+ * PredecessorIndex.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "PredecessorIndex.h"
+#include <algorithm>
+
+using std::vector;
+using std::pair;
+
+struct InputIDComp {
+	bool operator()(const pair<int, int>& lhs, const pair<int, int>& rhs) const {
+		return lhs.first < rhs.first;
+	}
+};
+
+void PredecessorIndex::build(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states) {
+	int nStates = states.size();
+
+	//bucket the transitions (input, predecessor) by their target state
+	vector<int> nTransTo(nStates+1, 0);
+	for (int s=0; s<nStates; s++) {
+		for (vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > >::iterator it=states[s].begin(); it!=states[s].end(); ++it) {
+			nTransTo[(it->second).first+1]++;
+		}
+	}
+	for (int s=0; s<nStates; s++) nTransTo[s+1] += nTransTo[s];
+
+	vector<pair<int, int> > transTo(nTransTo[nStates]);
+	vector<int> nextPos(nTransTo.begin(), nTransTo.end()-1);
+	for (int s=0; s<nStates; s++) {
+		for (vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > >::iterator it=states[s].begin(); it!=states[s].end(); ++it) {
+			transTo[nextPos[(it->second).first]++] = std::make_pair(it->first->id, s);
+		}
+	}
+
+	groupStart.assign(nStates+1, 0);
+	groupInput.clear();
+	predStart.clear();
+	predStates.clear();
+	predStates.reserve(transTo.size());
+
+	//within the bucket of each state, group the predecessors by input
+	for (int s=0; s<nStates; s++) {
+		groupStart[s] = groupInput.size();
+
+		vector<pair<int, int> >::iterator bucketBegin = transTo.begin()+nTransTo[s];
+		vector<pair<int, int> >::iterator bucketEnd = transTo.begin()+nTransTo[s+1];
+		std::stable_sort(bucketBegin, bucketEnd, InputIDComp());
+
+		for (vector<pair<int, int> >::iterator it=bucketBegin; it!=bucketEnd; ++it) {
+			if (it==bucketBegin || it->first!=(it-1)->first) {
+				groupInput.push_back(it->first);
+				predStart.push_back(predStates.size());
+			}
+			predStates.push_back(it->second);
+		}
+	}
+	groupStart[nStates] = groupInput.size();
+	predStart.push_back(predStates.size());
+}
+
+void TransitionIndex::build(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states) {
+	transStart.clear();
+	transInput.clear();
+	transOutput.clear();
+
+	for (unsigned int s=0; s<states.size(); s++) {
+		transStart.push_back(transInput.size());
+		for (vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > >::iterator it=states[s].begin(); it!=states[s].end(); ++it) {
+			transInput.push_back(it->first->id);
+			transOutput.push_back((it->second).second);
+		}
+	}
+	transStart.push_back(transInput.size());
+}
+
+void computeInputsOverlap(vector<IncSpecSeq*>& inputs, BitMatrix& inputsOverlap) {
+	int nInputs = inputs.size();
+	inputsOverlap.resize(nInputs, nInputs);
+	for (int i=0; i<nInputs; i++) {
+		for (int j=i; j<nInputs; j++) {
+			if (inputs[i]->isDisjoint(*inputs[j])) continue;
+			inputsOverlap.set(i, j);
+			inputsOverlap.set(j, i);
+		}
+	}
+}
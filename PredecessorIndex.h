@@ -0,0 +1,45 @@
+/*
+ * PredecessorIndex.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef PREDECESSORINDEX_H_
+#define PREDECESSORINDEX_H_
+
+#include <vector>
+#include <utility>
+
+#include "IncSpecSeq.h"
+#include "BitMatrix.h"
+
+//predecessors of each state, grouped by input, in compressed sparse row format:
+//the groups of state s are groupStart[s], ..., groupStart[s+1]-1;
+//group g contains the states predStates[predStart[g]], ..., predStates[predStart[g+1]-1], which have a transition with input groupInput[g] to s
+class PredecessorIndex {
+public:
+	std::vector<int> groupStart;
+	std::vector<int> groupInput;
+	std::vector<int> predStart;
+	std::vector<int> predStates;
+
+	//the inputs of the machine must have been interned by the parser (i.e., their id must be set)
+	void build(std::vector<std::vector<std::pair<IncSpecSeq*, std::pair<int, IncSpecSeq*> > > >& states);
+};
+
+//transitions of each state in compressed sparse row format:
+//the transitions of state s are transStart[s], ..., transStart[s+1]-1; transition t has the input with id transInput[t] and the output transOutput[t]
+class TransitionIndex {
+public:
+	std::vector<int> transStart;
+	std::vector<int> transInput;
+	std::vector<IncSpecSeq*> transOutput;
+
+	//the inputs of the machine must have been interned by the parser (i.e., their id must be set)
+	void build(std::vector<std::vector<std::pair<IncSpecSeq*, std::pair<int, IncSpecSeq*> > > >& states);
+};
+
+//inputsOverlap[i][j]==1 iff the inputs with IDs i and j are not disjoint
+void computeInputsOverlap(std::vector<IncSpecSeq*>& inputs, BitMatrix& inputsOverlap);
+
+#endif /* PREDECESSORINDEX_H_ */
@@ -0,0 +1,173 @@
+/*
+ * UpperBound.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+#include "UpperBound.h"
+#include <algorithm>
+#include <utility>
+#include <string.h>
+#include <sys/time.h>
+
+using std::vector;
+using std::pair;
+using std::make_pair;
+
+//partition of the states that is closed under the transition function; classes are represented by union-find trees
+class ClosedPartition {
+public:
+	ClosedPartition(vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix) : incomp(incompMatrix) {
+		int nStates = nextStatesMap.size();
+		parent.resize(nStates);
+		members.resize(nStates);
+		succ = nextStatesMap;
+		for (int s=0; s<nStates; s++) {
+			parent[s] = s;
+			members[s].push_back(s);
+		}
+	}
+
+	//no path compression, so that merges can be undone
+	int find(int s) const {
+		while (parent[s]!=s) s = parent[s];
+		return s;
+	}
+
+	//merges the classes of s1 and s2, and all classes that need to be merged for the partition to stay closed
+	//if this would merge incompatible states, the partition is left unchanged and false is returned
+	bool tryMerge(int s1, int s2) {
+		undoLog.clear();
+
+		vector<pair<int, int> > worklist;
+		worklist.push_back(make_pair(s1, s2));
+
+		while (!worklist.empty()) {
+			int r1 = find(worklist.back().first);
+			int r2 = find(worklist.back().second);
+			worklist.pop_back();
+			if (r1==r2) continue;
+
+			if (members[r1].size() < members[r2].size()) std::swap(r1, r2);
+
+			for (vector<int>::iterator it=members[r2].begin(); it!=members[r2].end(); it++) {
+				if (incomp.get(r1, *it)) {
+					undo();
+					return false;
+				}
+			}
+
+			MergeRecord record;
+			record.root = r1;
+			record.child = r2;
+			record.nMembers = members[r1].size();
+			record.incompRow.assign(incomp.row(r1), incomp.row(r1)+incomp.rowWords());
+			record.succ = succ[r1];
+			undoLog.push_back(record);
+
+			parent[r2] = r1;
+			members[r1].insert(members[r1].end(), members[r2].begin(), members[r2].end());
+			incomp.orRow(r2, incomp.row(r1));
+
+			vector<int>& succ1 = succ[r1];
+			vector<int>& succ2 = succ[r2];
+			for (unsigned int a=0; a<succ1.size(); a++) {
+				if (succ2[a]==-1) continue;
+				if (succ1[a]==-1) {
+					succ1[a] = succ2[a];
+				} else {
+					worklist.push_back(make_pair(succ1[a], succ2[a]));
+				}
+			}
+		}
+
+		for (vector<MergeRecord>::iterator it=undoLog.begin(); it!=undoLog.end(); it++) {
+			vector<int>().swap(members[it->child]);
+			vector<int>().swap(succ[it->child]);
+		}
+		return true;
+	}
+
+private:
+	vector<int> parent;
+	vector<vector<int> > members;
+	//row r is the union of the incompatible states of the members of class r
+	BitMatrix incomp;
+	//succ[r][a] is a state in the class that contains all successors of the members of class r on input a (or -1 if there are no successors)
+	vector<vector<int> > succ;
+
+	struct MergeRecord {
+		int root;
+		int child;
+		unsigned int nMembers;
+		vector<uint64_t> incompRow;
+		vector<int> succ;
+	};
+	vector<MergeRecord> undoLog;
+
+	void undo() {
+		for (vector<MergeRecord>::reverse_iterator it=undoLog.rbegin(); it!=undoLog.rend(); it++) {
+			parent[it->child] = it->child;
+			members[it->root].resize(it->nMembers);
+			memcpy(incomp.row(it->root), &it->incompRow[0], it->incompRow.size()*sizeof(uint64_t));
+			succ[it->root].swap(it->succ);
+		}
+		undoLog.clear();
+	}
+};
+
+struct MoreIncompatibleStates {
+	vector<unsigned int>* nIncomp;
+	bool operator()(int s1, int s2) const {
+		return (*nIncomp)[s1] > (*nIncomp)[s2];
+	}
+};
+
+int computeGreedyPartition(vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& stateClass, double timeLimit) {
+	timeval now;
+	gettimeofday(&now, 0);
+	double deadline = now.tv_sec + now.tv_usec/1e6 + timeLimit;
+
+	int nStates = nextStatesMap.size();
+	ClosedPartition partition(nextStatesMap, incompMatrix);
+
+	//states with many incompatible states are assigned first
+	vector<unsigned int> nIncomp(nStates);
+	vector<int> order(nStates);
+	for (int s=0; s<nStates; s++) {
+		nIncomp[s] = incompMatrix.countRow(s);
+		order[s] = s;
+	}
+	MoreIncompatibleStates comp;
+	comp.nIncomp = &nIncomp;
+	std::stable_sort(order.begin(), order.end(), comp);
+
+	//a state of each class that has been created so far
+	vector<int> classStates;
+	for (vector<int>::iterator sIt=order.begin(); sIt!=order.end(); sIt++) {
+		if (timeLimit>=0 && ((sIt-order.begin())&63)==0) {
+			gettimeofday(&now, 0);
+			if (now.tv_sec + now.tv_usec/1e6 > deadline) break;
+		}
+
+		int s = *sIt;
+		bool assigned = false;
+		for (vector<int>::iterator cIt=classStates.begin(); cIt!=classStates.end(); cIt++) {
+			if (partition.find(*cIt)==partition.find(s) || partition.tryMerge(*cIt, s)) {
+				assigned = true;
+				break;
+			}
+		}
+		if (!assigned) classStates.push_back(s);
+	}
+
+	//classes might have been merged as a consequence of later merges
+	vector<int> rootToClass(nStates, -1);
+	int nClasses = 0;
+	stateClass.resize(nStates);
+	for (int s=0; s<nStates; s++) {
+		int root = partition.find(s);
+		if (rootToClass[root]==-1) rootToClass[root] = nClasses++;
+		stateClass[s] = rootToClass[root];
+	}
+	return nClasses;
+}
@@ -0,0 +1,21 @@
+/*
+ * UpperBound.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef UPPERBOUND_H_
+#define UPPERBOUND_H_
+
+#include <vector>
+
+#include "BitMatrix.h"
+
+//computes a partition of the states into classes of pairwise compatible states that is closed under the transition function
+//(i.e., for every class and input, all successors are in the same class); such a partition corresponds to a reduced machine
+//the classes are built greedily: each state is merged into the first class with which it can be merged, merging successor classes as required
+//stateClass[s] is the class of state s; returns the number of classes
+//if timeLimit is not negative, no further states are merged after timeLimit seconds (the partition is closed after each merge, so the result is still valid)
+int computeGreedyPartition(std::vector<std::vector<int> >& nextStatesMap, BitMatrix& incompMatrix, std::vector<int>& stateClass, double timeLimit);
+
+#endif /* UPPERBOUND_H_ */
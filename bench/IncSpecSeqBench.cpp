@@ -0,0 +1,123 @@
+/*
+ * IncSpecSeqBench.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+//microbenchmark for the IncSpecSeq kernels (compatibility/disjointness and subset tests) on different sequence widths
+//each kernel is measured on pairs of distinct sequences, once on pairs for which it has to compare all words (conflict: compatible sequences,
+//contains: the second sequence has a subset of the specified bits of the first one), and once on unrelated random sequences, for which it
+//usually exits early at a conflict or a mismatch
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+#include "../IncSpecSeq.h"
+#include "../IncSpecSeqKernels.h"
+
+using std::vector;
+using std::string;
+
+const int N_SEQS = 64;
+
+string randomSeq(unsigned int length, const string& base) {
+	string s = base;
+	for (unsigned int i=0; i<length; i++) {
+		//don't cares are only added, so all sequences stay compatible with the base
+		if (rand()%3==0) s[i] = '-';
+	}
+	return s;
+}
+
+string randomBase(unsigned int length) {
+	string s(length, '0');
+	for (unsigned int i=0; i<length; i++) s[i] = '0'+rand()%2;
+	return s;
+}
+
+//the benchmarks compare seqs1[i] with seqs2[partner(i)]; partner(i) != i
+inline int partner(long i) {
+	return (i*7+3)%N_SEQS;
+}
+
+double usecSince(timeval& start) {
+	timeval end;
+	gettimeofday(&end, 0);
+	return (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec);
+}
+
+double benchConflict(SeqConflictKernel kernel, vector<IncSpecSeq>& seqs1, vector<IncSpecSeq>& seqs2, long iterations, int& sink) {
+	unsigned int nWords = seqs1[0].seq.size();
+	timeval start;
+	gettimeofday(&start, 0);
+	for (long it=0; it<iterations; it++) {
+		IncSpecSeq& a = seqs1[it%N_SEQS];
+		IncSpecSeq& b = seqs2[partner(it)];
+		sink += kernel(a.seq.data(), a.specifiedBits.data(), b.seq.data(), b.specifiedBits.data(), nWords);
+	}
+	return usecSince(start)*1000/iterations;
+}
+
+double benchContains(SpecContainsKernel kernel, vector<IncSpecSeq>& seqs1, vector<IncSpecSeq>& seqs2, long iterations, int& sink) {
+	unsigned int nWords = seqs1[0].seq.size();
+	timeval start;
+	gettimeofday(&start, 0);
+	for (long it=0; it<iterations; it++) {
+		IncSpecSeq& a = seqs1[it%N_SEQS];
+		IncSpecSeq& b = seqs2[partner(it)];
+		sink += kernel(a.specifiedBits.data(), b.specifiedBits.data(), nWords);
+	}
+	return usecSince(start)*1000/iterations;
+}
+
+void benchKernels(const char* name, unsigned int width, SeqConflictKernel conflict, SpecContainsKernel contains, vector<IncSpecSeq>& compatible, vector<IncSpecSeq>& subsets, vector<IncSpecSeq>& unrelated, long iterations, int& sink) {
+	double conflictFull = benchConflict(conflict, compatible, compatible, iterations, sink);
+	double conflictEarly = benchConflict(conflict, unrelated, unrelated, iterations, sink);
+	double containsFull = benchContains(contains, compatible, subsets, iterations, sink);
+	double containsEarly = benchContains(contains, unrelated, unrelated, iterations, sink);
+	printf("%-7u %-10s %8.2fns %8.2fns %8.2fns %8.2fns\n", width, name, conflictFull, conflictEarly, containsFull, containsEarly);
+}
+
+int main(int argc, char* argv[]) {
+	long iterations = (argc>1) ? atol(argv[1]) : 2000000;
+	unsigned int widths[] = {192, 256, 384, 512, 1024, 4096};
+	int sink = 0;
+
+	printf("selected kernels: %s\n", seqKernelName());
+	printf("%-7s %-10s %10s %10s %10s %10s\n", "bits", "kernel", "conflict", "(early)", "contains", "(early)");
+
+	for (unsigned int w=0; w<sizeof(widths)/sizeof(widths[0]); w++) {
+		unsigned int width = widths[w];
+		string base = randomBase(width);
+
+		//compatible: don't cares added to a common base; subsets[partner(i)]: more don't cares added to compatible[i];
+		//unrelated: random don't cares added to independent random sequences
+		vector<string> compatibleStrs(N_SEQS);
+		vector<string> subsetStrs(N_SEQS);
+		vector<IncSpecSeq> compatible, subsets, unrelated;
+		for (int i=0; i<N_SEQS; i++) compatibleStrs[i] = randomSeq(width, base);
+		for (int i=0; i<N_SEQS; i++) subsetStrs[partner(i)] = randomSeq(width, compatibleStrs[i]);
+		for (int i=0; i<N_SEQS; i++) {
+			compatible.push_back(IncSpecSeq(compatibleStrs[i]));
+			subsets.push_back(IncSpecSeq(subsetStrs[i]));
+			string unrelatedStr = randomSeq(width, randomBase(width));
+			unrelated.push_back(IncSpecSeq(unrelatedStr));
+		}
+
+		benchKernels("scalar", width, seqConflictScalar, specContainsScalar, compatible, subsets, unrelated, iterations, sink);
+#ifdef INCSPECSEQ_X86_KERNELS
+		benchKernels("SSE2", width, seqConflictSSE2, specContainsSSE2, compatible, subsets, unrelated, iterations, sink);
+		if (__builtin_cpu_supports("avx2")) {
+			benchKernels("AVX2", width, seqConflictAVX2, specContainsAVX2, compatible, subsets, unrelated, iterations, sink);
+		}
+#endif
+	}
+
+	//prevents the compiler from removing the benchmark loops
+	if (sink == -1) printf("%d\n", sink);
+	return 0;
+}
@@ -12,5 +12,31 @@ extern int verbosity;
 extern bool firstStateReset;
 extern bool noPartialSolutionInSat;
 extern bool noLowerBound;
+extern bool incrementalSat;
+extern int nThreads;
+extern bool parallelClasses;
+extern bool decompose;
+extern bool noUpperBound;
+extern bool noEquivalentStates;
+extern bool simplifyCNF;
+extern bool lbdSolver;
+extern int portfolioSize;
+extern bool shareClauses;
+extern bool reusePhases;
+extern double timeout;
+extern long long conflictBudget;
+extern long long propagationBudget;
+
+enum SearchStrategy {SEARCH_LINEAR, SEARCH_BINARY, SEARCH_GALLOP, SEARCH_DOWN};
+extern SearchStrategy searchStrategy;
+
+enum SymmetryBreaking {SYMMETRY_NONE, SYMMETRY_MIN, SYMMETRY_LEX};
+extern SymmetryBreaking symmetryBreaking;
+
+enum BranchingHeuristic {BRANCHING_NONE, BRANCHING_INCOMP, BRANCHING_GREEDY};
+extern BranchingHeuristic branchingHeuristic;
+
+extern double maxCliqueTime;
+extern double cliqueSearchTime;
 
 #endif /* GLOBAL_H_ */
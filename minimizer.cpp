@@ -7,8 +7,14 @@
 #include <sys/time.h>
 #include <unordered_map>
 #include <unordered_set>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <climits>
+#include <chrono>
 
 #include "minisat/core/Solver.h"
+#include "minisat/simp/SimpSolver.h"
 #include "minisat/utils/System.h"
 
 #include "global.h"
@@ -16,6 +22,12 @@
 #include "IncSpecSeq.h"
 #include "DIMACSWriter.h"
 #include "MachineBuilder.h"
+#include "BitMatrix.h"
+#include "PredecessorIndex.h"
+#include "BinaryMachine.h"
+#include "UpperBound.h"
+#include "MaxClique.h"
+#include "EquivalentStates.h"
 
 using std::cout;
 using std::endl;
@@ -27,6 +39,7 @@ using std::set;
 using std::pair;
 using std::sort;
 using std::queue;
+using std::make_pair;
 using namespace Minisat;
 
 void printStats(Solver& solver) {
@@ -42,17 +55,61 @@ void printStats(Solver& solver) {
 }
 
 void removeUnreachableStates(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& machine, int& resetState);
-void computePredecessorMap(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, unordered_map<IncSpecSeq*,vector<int> > pred[]);
-void computeIncompMatrix(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, unordered_map<IncSpecSeq*,vector<int> > pred[], vector<bool>& incompMatrix);
-vector<vector<bool> > getTransitivelyCompatibleStates(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, vector<bool>& incompMatrix);
-void splitTransitions(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, vector<bool>& incompMatrix, vector<vector<int> >& newNextStates, vector<vector<IncSpecSeq*> >& newOutput, vector<IncSpecSeq>& inputIDToIncSpecSeq);
+unsigned long long computeIncompMatrix(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, PredecessorIndex& pred, BitMatrix& inputsOverlap, BitMatrix& incompMatrix);
+vector<vector<bool> > getTransitivelyCompatibleStates(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, BitMatrix& incompMatrix);
+void splitTransitions(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, BitMatrix& incompMatrix, vector<vector<int> >& newNextStates, vector<vector<IncSpecSeq*> >& newOutput, vector<IncSpecSeq>& inputIDToIncSpecSeq);
 unordered_set<IncSpecSeq> getDisjointInputSet(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, vector<bool>& eqClass);
-void findPairwiseIncStates(vector<int>& pairwiseIncStates, vector<bool>& incompMatrix, int nStates);
+void findPairwiseIncStates(vector<int>& pairwiseIncStates, BitMatrix& incompMatrix, int nStates);
+lbool solveWithLimits(Solver& S, vec<Lit>& assumptions);
+Solver* newSolver();
+void encodeCNF(Solver* S, int nClasses, vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, int maxInput, vector<pair<int, int> >& literalToStateClass, vector<int>& phaseHint);
+void initBranching(Solver* S, int nClasses, vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, vector<pair<int, int> >& literalToStateClass);
+void setStatePhases(Solver* S, vector<pair<int, int> >& literalToStateClass, vector<int>& stateClass);
+void getGreedyStateClasses(vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, vector<int>& stateClass);
+void getFinalStateClasses(Solver* S, lbool ret, vector<pair<int, int> >& literalToStateClass, int nStates, vector<int>& stateClass);
+void timeoutWatchdog();
+double limitByTimeout(double timeLimit);
+lbool solveForClasses(int nClasses, vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, int maxInput, int& satClasses, Solver*& satSolver, vector<pair<int, int> >& literalToStateClass, vector<int>& phaseHint);
+lbool solvePortfolio(int nClasses, vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, int maxInput, vector<pair<int, int> >& literalToStateClass, vector<int>& phaseHint, Solver*& solver);
+bool searchClasses(int& lowerBound, int& upperBound, vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, int maxInput, int& satClasses, Solver*& satSolver, vector<pair<int, int> >& literalToStateClass, vector<int>& phaseHint);
+Solver* solveClassesInParallel(unsigned int lowerBound, int upperBound, vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, int maxInput, vector<pair<int, int> >& literalToStateClass, int& nClasses, bool& limitReached, int& provenLowerBound);
+int getIndependentComponents(vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& component);
+void solveComponents(vector<int>& component, int nComponents, vector<int>& pairwiseIncStates, vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<vector<IncSpecSeq*> >& outputsMap, int resetState, int numInputBits, int numOutputBits, vector<IncSpecSeq>& inputIDToIncSpecSeq);
+void writeResult(Solver& S, vector<pair<int, int> >& literalToStateClass, int nClasses, vector<vector<int> >& nextStatesMap, vector<vector<IncSpecSeq*> >& outputsMap, int resetState, int numInputBits, int numOutputBits, vector<IncSpecSeq>& inputIDToIncSpecSeq);
+void writePartitionResult(vector<int>& stateClass, int nClasses, vector<vector<int> >& nextStatesMap, vector<vector<IncSpecSeq*> >& outputsMap, int resetState, int numInputBits, int numOutputBits, vector<IncSpecSeq>& inputIDToIncSpecSeq);
+void writeMachine(vector<int>& dimacsOutput, vector<pair<int, int> >& literalToStateClass, int nClasses, vector<vector<int> >& nextStatesMap, vector<vector<IncSpecSeq*> >& outputsMap, int resetState, int numInputBits, int numOutputBits, vector<IncSpecSeq>& inputIDToIncSpecSeq);
+void writeLimitResult(int lowerBound, Solver* satSolver, vector<pair<int, int> >& literalToStateClass, int satClasses, int heuristicClasses, vector<vector<int> >& nextStatesMap, vector<vector<IncSpecSeq*> >& outputsMap, int resetState, int numInputBits, int numOutputBits, vector<IncSpecSeq>& inputIDToIncSpecSeq);
 
 int verbosity = 0;
 bool firstStateReset = true;
 bool noPartialSolutionInSat = false;
 bool noLowerBound = false;
+bool incrementalSat = false;
+int nThreads = 1;
+bool parallelClasses = false;
+bool decompose = false;
+bool noUpperBound = false;
+bool noEquivalentStates = false;
+bool simplifyCNF = false;
+bool lbdSolver = false;
+int portfolioSize = 1;
+bool shareClauses = false;
+bool reusePhases = false;
+double timeout = 0;
+long long conflictBudget = -1;
+long long propagationBudget = -1;
+SearchStrategy searchStrategy = SEARCH_LINEAR;
+SymmetryBreaking symmetryBreaking = SYMMETRY_NONE;
+BranchingHeuristic branchingHeuristic = BRANCHING_NONE;
+double maxCliqueTime = 0;
+double cliqueSearchTime = 0;
+
+//solvers that are currently running; they are interrupted when the timeout expires
+std::mutex runningSolversMutex;
+set<Solver*> runningSolvers;
+bool timeoutExpired = false;
+//time (in seconds since the epoch) at which the timeout expires
+double timeoutDeadline;
 
 void usage() {
 	cout << "Usage: ./MeMin [Options] <input.kiss>" << endl;
@@ -63,7 +120,73 @@ void usage() {
 	cout << "  -np       do not include the 'partial solution' in the SAT problem" << endl;
 	cout << "  -nl       like -np, but does also not use the size of the 'partial solution'" << endl;
 	cout << "            as a lower bound (i.e., does not need the partial solution at all)" << endl;
+	cout << "  --clique-search SEC" << endl;
+	cout << "            improve the set of pairwise incompatible states for the partial solution by a" << endl;
+	cout << "            randomized local search on the number of threads specified by -j (for SEC seconds)" << endl;
+	cout << "  --max-clique SEC" << endl;
+	cout << "            search for a maximum set of pairwise incompatible states for the partial" << endl;
+	cout << "            solution (for at most SEC seconds), instead of using only a greedy heuristic" << endl;
+	cout << "  -ne       do not merge equivalent states before the incompatible states are computed" << endl;
+	cout << "            (states with the same inputs and outputs, and equivalent successors)" << endl;
+	cout << "  -nu       do not compute a heuristic solution before the SAT solver is used" << endl;
+	cout << "            (otherwise, it is written to result.kiss as a preliminary result, and its" << endl;
+	cout << "            size is used as an upper bound for the number of classes)" << endl;
+	cout << "  -inc      use a single incremental SAT solver for all numbers of classes" << endl;
+	cout << "            (classes are activated via assumptions, learnt clauses are kept)" << endl;
+	cout << "  -simp     simplify the SAT problems by variable elimination and subsumption before they" << endl;
+	cout << "            are solved (ignored with -inc)" << endl;
+	cout << "  -lbd      Glucose-style SAT solving: learnt clauses are deleted by their LBD (clauses" << endl;
+	cout << "            with LBD <= 2 are kept), restarts depend on the LBDs instead of the Luby sequence" << endl;
+	cout << "  --search={linear,binary,gallop,down}" << endl;
+	cout << "            order in which the numbers of classes are tried (default: linear)" << endl;
+	cout << "            linear: upwards from the lower bound; binary: bisection between the lower" << endl;
+	cout << "            and the upper bound; gallop: lower bound + 0, 1, 3, 7, ... until a solution" << endl;
+	cout << "            is found, then bisection; down: downwards from the upper bound" << endl;
+	cout << "            (ignored with -inc and -par)" << endl;
+	cout << "  --symmetry={none,min,lex}" << endl;
+	cout << "            symmetry-breaking clauses for the classes that are not fixed by the partial" << endl;
+	cout << "            solution (default: none); min: these classes are ordered by their smallest" << endl;
+	cout << "            state; lex: these classes are ordered lexicographically by their states" << endl;
+	cout << "  --branching={none,incomp,greedy}" << endl;
+	cout << "            initial decision heuristic of the SAT solver (default: none); incomp: states that" << endl;
+	cout << "            are incompatible with many states are placed first, each state preferably in its" << endl;
+	cout << "            class in a greedy coloring of the incompatibility graph; greedy: like incomp, but" << endl;
+	cout << "            with the classes of the heuristic solution (ignored with -inc)" << endl;
+	cout << "  --reuse-phases" << endl;
+	cout << "            the SAT solver prefers the classes of the previous SAT problem's final assignment" << endl;
+	cout << "            (the classes of the heuristic solution for the first problem); this overrides the" << endl;
+	cout << "            polarities of --branching (ignored with -inc and -par)" << endl;
+	cout << "  --decompose" << endl;
+	cout << "            minimize independent components of the machine (i.e., sets of states that are" << endl;
+	cout << "            neither compatible with nor reachable from other states) separately, on the" << endl;
+	cout << "            number of threads specified by -j (ignored with -inc and -par)" << endl;
+	cout << "  --portfolio N" << endl;
+	cout << "            solve each SAT problem with N differently configured solvers in parallel" << endl;
+	cout << "            (random seed, phase saving, restarts, activity decay); the first answer stops" << endl;
+	cout << "            the other solvers (ignored with -inc and -par)" << endl;
+	cout << "  --share-clauses" << endl;
+	cout << "            exchange learnt units and binary clauses between the solvers of a portfolio" << endl;
+	cout << "            (ignored with -simp)" << endl;
+	cout << "  -j N      number of threads" << endl;
+	cout << "  -par      solve the SAT problems for several numbers of classes in parallel" << endl;
+	cout << "            (on the number of threads specified by -j)" << endl;
+	cout << "  --timeout SEC" << endl;
+	cout << "            stop after SEC seconds (wall-clock time): the SAT solver is interrupted, the clique" << endl;
+	cout << "            searches and the heuristic solution are cut short, and no further CNFs are built;" << endl;
+	cout << "            parsing, the computation of the incompatible states, and a CNF that is being built" << endl;
+	cout << "            are not interrupted" << endl;
+	cout << "  --conflict-budget N" << endl;
+	cout << "            stop the SAT solver after N conflicts (per SAT problem)" << endl;
+	cout << "  --propagation-budget N" << endl;
+	cout << "            stop the SAT solver after N propagations (per SAT problem)" << endl;
+	cout << "  if one of the limits --timeout, --conflict-budget and --propagation-budget is reached," << endl;
+	cout << "            the best solution found so far is written to result.kiss, and a lower bound on" << endl;
+	cout << "            the number of states of a minimal solution is printed" << endl;
 	cout << "  -v {0,1}  verbosity level" << endl;
+	cout << "  --save-binary FILE  write the parsed machine in a binary format to FILE" << endl;
+	cout << "  --load-binary       the input file is in the binary format (written by --save-binary)" << endl;
+	cout << "            the file contains the reset state, so -r cannot be used with --load-binary" << endl;
+	cout << "            (it has to be used with --save-binary instead)" << endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -72,8 +195,11 @@ int main(int argc, char* argv[]) {
 
 	int resetState;
 	vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > > machine;
+	vector<IncSpecSeq*> inputs;
 	int numInputBits;
 	int numOutputBits;
+	bool loadBinary = false;
+	char* saveBinaryFile = NULL;
 
 	for (int argI=1; argI < argc-1; argI++) {
 		char* arg = argv[argI];
@@ -83,6 +209,120 @@ int main(int argc, char* argv[]) {
 			noPartialSolutionInSat = true;
 		} else if (strcmp(arg,"-nl")==0) {
 			noLowerBound = true;
+		} else if (strcmp(arg,"--clique-search")==0) {
+			argI++;
+			cliqueSearchTime = atof(argv[argI]);
+			if (cliqueSearchTime<=0) {
+				usage();
+				return 1;
+			}
+		} else if (strcmp(arg,"--max-clique")==0) {
+			argI++;
+			maxCliqueTime = atof(argv[argI]);
+			if (maxCliqueTime<=0) {
+				usage();
+				return 1;
+			}
+		} else if (strcmp(arg,"-ne")==0) {
+			noEquivalentStates = true;
+		} else if (strcmp(arg,"-nu")==0) {
+			noUpperBound = true;
+		} else if (strcmp(arg,"-simp")==0) {
+			simplifyCNF = true;
+		} else if (strcmp(arg,"-lbd")==0) {
+			lbdSolver = true;
+		} else if (strcmp(arg,"-inc")==0) {
+			incrementalSat = true;
+		} else if (strncmp(arg,"--search=",9)==0) {
+			const char* strategy = arg+9;
+			if (strcmp(strategy,"linear")==0) {
+				searchStrategy = SEARCH_LINEAR;
+			} else if (strcmp(strategy,"binary")==0) {
+				searchStrategy = SEARCH_BINARY;
+			} else if (strcmp(strategy,"gallop")==0) {
+				searchStrategy = SEARCH_GALLOP;
+			} else if (strcmp(strategy,"down")==0) {
+				searchStrategy = SEARCH_DOWN;
+			} else {
+				usage();
+				return 1;
+			}
+		} else if (strncmp(arg,"--symmetry=",11)==0) {
+			const char* mode = arg+11;
+			if (strcmp(mode,"none")==0) {
+				symmetryBreaking = SYMMETRY_NONE;
+			} else if (strcmp(mode,"min")==0) {
+				symmetryBreaking = SYMMETRY_MIN;
+			} else if (strcmp(mode,"lex")==0) {
+				symmetryBreaking = SYMMETRY_LEX;
+			} else {
+				usage();
+				return 1;
+			}
+		} else if (strncmp(arg,"--branching=",12)==0) {
+			const char* mode = arg+12;
+			if (strcmp(mode,"none")==0) {
+				branchingHeuristic = BRANCHING_NONE;
+			} else if (strcmp(mode,"incomp")==0) {
+				branchingHeuristic = BRANCHING_INCOMP;
+			} else if (strcmp(mode,"greedy")==0) {
+				branchingHeuristic = BRANCHING_GREEDY;
+			} else {
+				usage();
+				return 1;
+			}
+		} else if (strcmp(arg,"--reuse-phases")==0) {
+			reusePhases = true;
+		} else if (strcmp(arg,"-par")==0) {
+			parallelClasses = true;
+		} else if (strcmp(arg,"--decompose")==0) {
+			decompose = true;
+		} else if (strcmp(arg,"--portfolio")==0) {
+			argI++;
+			portfolioSize = atoi(argv[argI]);
+			if (portfolioSize<1) {
+				usage();
+				return 1;
+			}
+		} else if (strcmp(arg,"--share-clauses")==0) {
+			shareClauses = true;
+		} else if (strcmp(arg,"-j")==0) {
+			argI++;
+			nThreads = atoi(argv[argI]);
+			if (nThreads<1) {
+				usage();
+				return 1;
+			}
+		} else if (strcmp(arg,"--save-binary")==0) {
+			argI++;
+			if (argI>=argc-1) {
+				usage();
+				return 1;
+			}
+			saveBinaryFile = argv[argI];
+		} else if (strcmp(arg,"--load-binary")==0) {
+			loadBinary = true;
+		} else if (strcmp(arg,"--timeout")==0) {
+			argI++;
+			timeout = atof(argv[argI]);
+			if (timeout<=0) {
+				usage();
+				return 1;
+			}
+		} else if (strcmp(arg,"--conflict-budget")==0) {
+			argI++;
+			conflictBudget = atoll(argv[argI]);
+			if (conflictBudget<0) {
+				usage();
+				return 1;
+			}
+		} else if (strcmp(arg,"--propagation-budget")==0) {
+			argI++;
+			propagationBudget = atoll(argv[argI]);
+			if (propagationBudget<0) {
+				usage();
+				return 1;
+			}
 		} else if (strcmp(arg,"-v")==0) {
 			argI++;
 			verbosity = argv[argI][0]-'0';
@@ -96,13 +336,34 @@ int main(int argc, char* argv[]) {
 		}
 	}
 
+	if (loadBinary && !firstStateReset) {
+		usage();
+		return 1;
+	}
+
+	if (timeout>0) {
+		timeval now;
+		gettimeofday(&now, 0);
+		timeoutDeadline = now.tv_sec + now.tv_usec/1e6 + timeout;
+		std::thread(timeoutWatchdog).detach();
+	}
+
 	if ((argc <= 1) || (argv[argc - 1] == NULL) || (argv[argc - 1][0] == '-')) {
 		usage();
 		return 1;
+	} else if (loadBinary) {
+		loadBinaryMachine(argv[argc-1], machine, inputs, resetState, numInputBits, numOutputBits);
 	} else {
-		parseKISSFile(argv[argc-1], machine, resetState, numInputBits, numOutputBits);
+		parseKISSFile(argv[argc-1], machine, inputs, resetState, numInputBits, numOutputBits);
+	}
+
+	if (saveBinaryFile!=NULL) {
+		saveBinaryMachine(saveBinaryFile, machine, inputs, resetState, numInputBits, numOutputBits);
 	}
 
+	BitMatrix inputsOverlap;
+	computeInputsOverlap(inputs, inputsOverlap);
+
 	gettimeofday(&end, 0);
 	if (verbosity>0) cout << "Parsing: "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
 	gettimeofday(&start, 0);
@@ -114,23 +375,30 @@ int main(int argc, char* argv[]) {
 		gettimeofday(&start, 0);
 	}
 
+	if (!noEquivalentStates) {
+		int nMerged = mergeEquivalentStates(machine, resetState, inputs.size());
+		gettimeofday(&end, 0);
+		if (verbosity>0) cout << "Merging equivalent states (" << nMerged << " states removed): "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
+		gettimeofday(&start, 0);
+	}
+
 	int nStates = machine.size();
 
 	//predecessors for each state and input
-	unordered_map<IncSpecSeq*,vector<int> > pred[nStates];
-	computePredecessorMap(machine, pred);
+	PredecessorIndex pred;
+	pred.build(machine);
 
 	gettimeofday(&end, 0);
 	if (verbosity>0) cout << "Computing pred map: "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
 	gettimeofday(&start, 0);
 
 	//0 if compatible, 1 if incompatible
-	vector<bool> incompMatrix;
-	incompMatrix.resize(nStates*nStates, false);
-	computeIncompMatrix(machine, pred, incompMatrix);
+	BitMatrix incompMatrix(nStates, nStates);
+	unsigned long long nProcessedPairs = computeIncompMatrix(machine, pred, inputsOverlap, incompMatrix);
 
 	gettimeofday(&end, 0);
 	if (verbosity>0) cout << "Computing IncompMatrix: "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
+	if (verbosity>0) cout << "Incompatible pairs processed: "<< nProcessedPairs << endl;
 	gettimeofday(&start, 0);
 
 	vector<vector<int> > nextStatesMap(nStates);
@@ -145,71 +413,1027 @@ int main(int argc, char* argv[]) {
 	gettimeofday(&start, 0);
 	vector<int> pairwiseIncStates;
 	if (!noLowerBound) findPairwiseIncStates(pairwiseIncStates, incompMatrix, nStates);
+	if (!noLowerBound && limitByTimeout(cliqueSearchTime)>0) {
+		unsigned int greedySize = pairwiseIncStates.size();
+		findCliqueMultiStart(incompMatrix, pairwiseIncStates, limitByTimeout(cliqueSearchTime), nThreads);
+		if (verbosity>0) cout << "Pairwise incomp states: " << greedySize << " (greedy), " << pairwiseIncStates.size() << " (local search)" << endl;
+	}
+	if (!noLowerBound && limitByTimeout(maxCliqueTime)>0) {
+		unsigned int greedySize = pairwiseIncStates.size();
+		bool maximum = findMaxClique(incompMatrix, pairwiseIncStates, limitByTimeout(maxCliqueTime));
+		if (verbosity>0) cout << "Pairwise incomp states: " << greedySize << " (greedy), " << pairwiseIncStates.size() << (maximum ? " (maximum)" : " (time limit reached)") << endl;
+	}
 	gettimeofday(&end, 0);
 	if (verbosity>0) cout << "Finding pairwise incomp states: "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
 	gettimeofday(&start, 0);
 
-	for (int nClasses=pairwiseIncStates.size(); nClasses>=0; nClasses++) {
-		if (verbosity>0) cout << "Classes: " << nClasses << endl;
+	//number of classes of a solution that is found by a greedy heuristic; this solution is written as a preliminary result
+	int heuristicClasses = INT_MAX;
+	if (!noUpperBound) {
+		vector<int> stateClass;
+		heuristicClasses = computeGreedyPartition(nextStatesMap, incompMatrix, stateClass, limitByTimeout(-1));
+
+		gettimeofday(&end, 0);
+		if (verbosity>0) cout << "Greedy upper bound (" << heuristicClasses << " classes): "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
+
+		writePartitionResult(stateClass, heuristicClasses, nextStatesMap, outputsMap, resetState, numInputBits, numOutputBits, inputIDToIncSpecSeq);
+		if (heuristicClasses <= (int)pairwiseIncStates.size()) {
+			cout << "Result written to result.kiss" << endl;
+			exit(0);
+		}
+		gettimeofday(&start, 0);
+	}
+
+	if (decompose && !parallelClasses && !incrementalSat) {
+		vector<int> component;
+		int nComponents = getIndependentComponents(nextStatesMap, incompMatrix, component);
+
+		gettimeofday(&end, 0);
+		if (verbosity>0) cout << "Finding independent components (" << nComponents << "): "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
+		gettimeofday(&start, 0);
+
+		if (nComponents>1) {
+			solveComponents(component, nComponents, pairwiseIncStates, nextStatesMap, incompMatrix, outputsMap, resetState, numInputBits, numOutputBits, inputIDToIncSpecSeq);
+
+			gettimeofday(&end, 0);
+			if (verbosity>0) cout << "Total time for SAT: "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
+			exit(0);
+		}
+	}
+
+	if (parallelClasses) {
+		unsigned int lowerBound = pairwiseIncStates.size();
 		if (noPartialSolutionInSat) pairwiseIncStates.clear();
 
+		vector<pair<int, int> > literalToStateClass;
+		int nClasses;
+		bool limitReached;
+		int provenLowerBound;
+		Solver* solver = solveClassesInParallel(lowerBound, heuristicClasses, nextStatesMap, incompMatrix, pairwiseIncStates, inputIDToIncSpecSeq.size()-1, literalToStateClass, nClasses, limitReached, provenLowerBound);
+
+		gettimeofday(&end, 0);
+		if (verbosity>0) cout << "Total time for SAT: "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
+		gettimeofday(&start, 0);
+
+		if (limitReached) {
+			writeLimitResult(provenLowerBound, solver, literalToStateClass, nClasses, heuristicClasses, nextStatesMap, outputsMap, resetState, numInputBits, numOutputBits, inputIDToIncSpecSeq);
+			exit(0);
+		}
+
+		if (solver==NULL) {
+			//the preliminary result is minimal
+			cout << "Result written to result.kiss" << endl;
+			exit(0);
+		}
+		writeResult(*solver, literalToStateClass, nClasses, nextStatesMap, outputsMap, resetState, numInputBits, numOutputBits, inputIDToIncSpecSeq);
+		exit(0);
+	}
+
+	if (incrementalSat) {
+		unsigned int lowerBound = pairwiseIncStates.size();
+		if (noPartialSolutionInSat) pairwiseIncStates.clear();
+
+		Solver* solver = NULL;
+		unsigned int maxClasses = 0;
+
 		//if literal i is true, and literalToStateClass[i]=(s,c) then state s is in class c
 		vector<pair<int, int> > literalToStateClass;
+		vector<int> classActivationLiterals;
+
+		for (unsigned int nClasses=lowerBound; ; nClasses++) {
+			if ((int)nClasses >= heuristicClasses) {
+				//the preliminary result is minimal
+				cout << "Result written to result.kiss" << endl;
+				exit(0);
+			}
+
+			if (verbosity>0) cout << "Classes: " << nClasses << endl;
+
+			timeval start2, end2;
+			gettimeofday(&start2, 0);
+
+			if (solver==NULL || nClasses>maxClasses) {
+				//all classes up to maxClasses are encoded once; if this is not sufficient, the bound is doubled
+				maxClasses = std::min((unsigned int)std::min(nStates, heuristicClasses), std::max(2*maxClasses, std::max(2*lowerBound, lowerBound+8)));
 
-		timeval start2, end2;
-		gettimeofday(&start2, 0);
+				delete solver;
+				solver = new Solver;
+				solver->lbd_mode = lbdSolver;
+				CNFEncoder encoder(solver);
+				encoder.buildIncrementalCNF(literalToStateClass, classActivationLiterals, maxClasses, nextStatesMap, incompMatrix, pairwiseIncStates, inputIDToIncSpecSeq.size()-1);
 
-		Solver S;
-		buildCNF(&S, literalToStateClass, nClasses, nextStatesMap, incompMatrix, pairwiseIncStates, inputIDToIncSpecSeq.size()-1);
+				gettimeofday(&end2, 0);
+				if (verbosity>0) cout << "Building CNF (up to " << maxClasses << " classes): "<< (end2.tv_sec*1e6 + end2.tv_usec) - (start2.tv_sec*1e6 + start2.tv_usec) << " usec" << endl;
+				gettimeofday(&start2, 0);
+			}
+
+			vec<Lit> assumptions;
+			if (nClasses<maxClasses) assumptions.push(~mkLit(classActivationLiterals[nClasses]-1));
+			lbool ret = solveWithLimits(*solver, assumptions);
+
+			gettimeofday(&end2, 0);
+			if (verbosity>0) cout << "Minisat: "<< (end2.tv_sec*1e6 + end2.tv_usec) - (start2.tv_sec*1e6 + start2.tv_usec) << " usec" << endl;
 
-		gettimeofday(&end2, 0);
-		if (verbosity>0) cout << "Building CNF: "<< (end2.tv_sec*1e6 + end2.tv_usec) - (start2.tv_sec*1e6 + start2.tv_usec) << " usec" << endl;
-		gettimeofday(&start2, 0);
+			if (verbosity>0) cout << (ret == l_True ? "SATISFIABLE\n" : ret == l_False ? "UNSATISFIABLE\n" : "INDETERMINATE\n");
+
+			if (verbosity>1) printStats(*solver);
+
+			if (ret == l_Undef) {
+				writeLimitResult(nClasses, NULL, literalToStateClass, -1, heuristicClasses, nextStatesMap, outputsMap, resetState, numInputBits, numOutputBits, inputIDToIncSpecSeq);
+				exit(0);
+			}
+
+			if (ret == l_True){
+				gettimeofday(&end, 0);
+				if (verbosity>0) cout << "Total time for SAT: "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
+				gettimeofday(&start, 0);
+
+				writeResult(*solver, literalToStateClass, nClasses, nextStatesMap, outputsMap, resetState, numInputBits, numOutputBits, inputIDToIncSpecSeq);
+				exit(0);
+			}
+		}
+	}
+
+	//all numbers of classes < lowerBound are unsatisfiable, upperBound is satisfiable
+	int lowerBound = pairwiseIncStates.size();
+	int upperBound = std::min(std::max(nStates, lowerBound), heuristicClasses);
+	if (noPartialSolutionInSat) pairwiseIncStates.clear();
+
+	//the smallest number of classes for which a solution has been found so far, and the corresponding solver
+	int satClasses = -1;
+	Solver* satSolver = NULL;
+	//if literal i is true, and literalToStateClass[i]=(s,c) then state s is in class c
+	vector<pair<int, int> > literalToStateClass;
+
+	int maxInput = inputIDToIncSpecSeq.size()-1;
+
+	vector<int> phaseHint;
+
+	//true if the SAT solver was stopped by the timeout or a budget
+	bool limitReached = searchClasses(lowerBound, upperBound, nextStatesMap, incompMatrix, pairwiseIncStates, maxInput, satClasses, satSolver, literalToStateClass, phaseHint);
+
+	if (!limitReached && satClasses != upperBound && upperBound == heuristicClasses) {
+		//the preliminary result is minimal
+		cout << "Result written to result.kiss" << endl;
+		exit(0);
+	}
+
+	if (!limitReached && satClasses != upperBound) {
+		limitReached = (solveForClasses(upperBound, nextStatesMap, incompMatrix, pairwiseIncStates, maxInput, satClasses, satSolver, literalToStateClass, phaseHint) == l_Undef);
+	}
+
+	if (limitReached) {
+		writeLimitResult(lowerBound, satSolver, literalToStateClass, satClasses, heuristicClasses, nextStatesMap, outputsMap, resetState, numInputBits, numOutputBits, inputIDToIncSpecSeq);
+		exit(0);
+	}
+
+	gettimeofday(&end, 0);
+	if (verbosity>0) cout << "Total time for SAT: "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
+	gettimeofday(&start, 0);
+
+	writeResult(*satSolver, literalToStateClass, satClasses, nextStatesMap, outputsMap, resetState, numInputBits, numOutputBits, inputIDToIncSpecSeq);
+	exit(0);
+}
+
+//solves the SAT problem with the given assumptions, subject to the timeout and the conflict and propagation budgets
+//if S is a SimpSolver, the CNF is first simplified by variable elimination and subsumption (which can also be interrupted by the timeout)
+//returns l_Undef if a limit was reached before the problem was solved
+lbool solveWithLimits(Solver& S, vec<Lit>& assumptions) {
+	if (conflictBudget>=0) S.setConfBudget(conflictBudget);
+	if (propagationBudget>=0) S.setPropBudget(propagationBudget);
+
+	{
+		std::lock_guard<std::mutex> lock(runningSolversMutex);
+		if (timeoutExpired) return l_Undef;
+		runningSolvers.insert(&S);
+	}
+
+	lbool ret;
+	SimpSolver* simpS = dynamic_cast<SimpSolver*>(&S);
+	if (simpS!=NULL) {
+		int nClauses = S.nClauses();
+
+		//SimpSolver::solveLimited hides Solver::solveLimited; only the former extends the model to the eliminated variables
+		//simplification is turned off afterwards, so a later call solves the CNF like a Solver
+		ret = simpS->solveLimited(assumptions, true, true);
+
+		if (verbosity>0) cout << "Simplification: " << simpS->eliminated_vars << " of " << S.nVars() << " variables eliminated, clauses: " << nClauses << " -> " << S.nClauses() << endl;
+	} else {
+		ret = S.solveLimited(assumptions);
+	}
+
+	std::lock_guard<std::mutex> lock(runningSolversMutex);
+	runningSolvers.erase(&S);
+	return ret;
+}
+
+//interrupts all running solvers when the timeout expires
+void timeoutWatchdog() {
+	std::this_thread::sleep_for(std::chrono::duration<double>(timeout));
+
+	std::lock_guard<std::mutex> lock(runningSolversMutex);
+	timeoutExpired = true;
+	for (set<Solver*>::iterator it=runningSolvers.begin(); it!=runningSolvers.end(); it++) {
+		(*it)->interrupt();
+	}
+}
+
+//returns the time limit (in seconds) for a phase that should end at the latest when the timeout expires (0 if it has already expired)
+//timeLimit is the limit of the phase itself (negative if it has none); the result is negative if neither the phase nor --timeout has a limit
+double limitByTimeout(double timeLimit) {
+	if (timeout<=0) return timeLimit;
+
+	timeval now;
+	gettimeofday(&now, 0);
+	double remaining = std::max(0.0, timeoutDeadline - (now.tv_sec + now.tv_usec/1e6));
+	return (timeLimit<0) ? remaining : std::min(timeLimit, remaining);
+}
+
+//returns a SimpSolver if the SAT problems are simplified (-simp), and a Solver otherwise
+//with -lbd, the solver manages its learnt clauses by their LBD and restarts dynamically
+Solver* newSolver() {
+	Solver* S;
+	if (simplifyCNF) {
+		S = new SimpSolver;
+	} else {
+		S = new Solver;
+	}
+	S->lbd_mode = lbdSolver;
+	return S;
+}
+
+//adds the CNF for nClasses classes to S; if S is a SimpSolver, the variables that assign states to classes are frozen
+//(i.e., they are not eliminated when the CNF is simplified in solveWithLimits), as they are needed to build the reduced machine
+void encodeCNF(Solver* S, int nClasses, vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, int maxInput, vector<pair<int, int> >& literalToStateClass, vector<int>& phaseHint) {
+	SimpSolver* simpS = dynamic_cast<SimpSolver*>(S);
+	if (simpS==NULL) {
+		CNFEncoder encoder(S);
+		encoder.buildCNF(literalToStateClass, nClasses, nextStatesMap, incompMatrix, pairwiseIncStates, maxInput);
+		if (branchingHeuristic!=BRANCHING_NONE) initBranching(S, nClasses, nextStatesMap, incompMatrix, pairwiseIncStates, literalToStateClass);
+		if (!phaseHint.empty()) setStatePhases(S, literalToStateClass, phaseHint);
+		return;
+	}
+
+	CNFEncoder encoder(simpS);
+	encoder.buildCNF(literalToStateClass, nClasses, nextStatesMap, incompMatrix, pairwiseIncStates, maxInput);
+	if (branchingHeuristic!=BRANCHING_NONE) initBranching(S, nClasses, nextStatesMap, incompMatrix, pairwiseIncStates, literalToStateClass);
+	if (!phaseHint.empty()) setStatePhases(S, literalToStateClass, phaseHint);
+
+	for (unsigned int lit=1; lit<literalToStateClass.size() && (int)lit<=simpS->nVars(); lit++) {
+		if (literalToStateClass[lit].first!=-1) simpS->setFrozen(lit-1, true);
+	}
+}
+
+//orders states by their number of incompatible states (decreasing)
+struct MoreIncompatibleStates {
+	vector<int>* nIncomp;
+	bool operator()(int s1, int s2) const {
+		return (*nIncomp)[s1] > (*nIncomp)[s2];
+	}
+};
+
+//initializes the decision heuristic for the literals that assign states to classes (--branching)
+//the activity of such a literal is proportional to the number of states that are incompatible with its state (at most 1, so that it is soon dominated
+//by the activity bumps of the conflicts); thus, the solver first places the states that are hardest to place
+//the preferred polarities put each state into one class: for BRANCHING_INCOMP, the classes are a greedy coloring of the incompatibility graph
+//(states with many incompatible states first, each into the first class that contains no incompatible state); for BRANCHING_GREEDY, the classes
+//of the greedy partition are used, which is also closed under the transition function; in both cases, the states of the partial solution
+//(pairwiseIncStates) keep their classes, and states for which no class < nClasses is found are not put into any class
+void initBranching(Solver* S, int nClasses, vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, vector<pair<int, int> >& literalToStateClass) {
+	int nStates = nextStatesMap.size();
+	vector<int> nIncomp(nStates);
+	int maxIncomp = 0;
+	for (int s=0; s<nStates; s++) {
+		nIncomp[s] = incompMatrix.countRow(s);
+		maxIncomp = std::max(maxIncomp, nIncomp[s]);
+	}
+	for (unsigned int lit=1; lit<literalToStateClass.size() && (int)lit<=S->nVars(); lit++) {
+		int s = literalToStateClass[lit].first;
+		if (s!=-1) S->setActivity(lit-1, (double)nIncomp[s]/(maxIncomp+1));
+	}
+
+	vector<int> stateClass(nStates, -1);
+	if (branchingHeuristic==BRANCHING_INCOMP) {
+		vector<int> states;
+		for (int s=0; s<nStates; s++) states.push_back(s);
+		MoreIncompatibleStates more;
+		more.nIncomp = &nIncomp;
+		std::stable_sort(states.begin(), states.end(), more);
+
+		//row c contains the states that are incompatible with a state in class c
+		BitMatrix incompWithClass(nClasses, nStates);
+		for (unsigned int i=0; i<pairwiseIncStates.size(); i++) {
+			stateClass[pairwiseIncStates[i]] = i;
+			incompMatrix.orRow(pairwiseIncStates[i], incompWithClass.row(i));
+		}
+		for (int i=0; i<nStates; i++) {
+			int s = states[i];
+			if (stateClass[s]!=-1) continue;
+			for (int c=0; c<nClasses; c++) {
+				if (incompWithClass.get(c, s)) continue;
+				stateClass[s] = c;
+				incompMatrix.orRow(s, incompWithClass.row(c));
+				break;
+			}
+		}
+	} else {
+		getGreedyStateClasses(nextStatesMap, incompMatrix, pairwiseIncStates, stateClass);
+	}
+	setStatePhases(S, literalToStateClass, stateClass);
+}
+
+//computes the greedy partition (see computeGreedyPartition); the classes of the states of the partial solution (pairwiseIncStates) are renamed
+//to their classes in the SAT problem, the other classes are numbered consecutively
+void getGreedyStateClasses(vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, vector<int>& stateClass) {
+	vector<int> greedyClass;
+	int nGreedyClasses = computeGreedyPartition(nextStatesMap, incompMatrix, greedyClass, -1);
+
+	vector<int> newClass(nGreedyClasses, -1);
+	for (unsigned int i=0; i<pairwiseIncStates.size(); i++) newClass[greedyClass[pairwiseIncStates[i]]] = i;
+	int nextClass = pairwiseIncStates.size();
+	for (int c=0; c<nGreedyClasses; c++) {
+		if (newClass[c]==-1) newClass[c] = nextClass++;
+	}
+	stateClass.resize(greedyClass.size());
+	for (unsigned int s=0; s<greedyClass.size(); s++) stateClass[s] = newClass[greedyClass[s]];
+}
+
+//stores a class of each state in the final assignment of S (the model if ret is l_True, the saved phases otherwise) in stateClass (-1 if there is none)
+//this assignment is used as phase hint for the next SAT problem (--reuse-phases); states that are in several classes get the smallest of them
+void getFinalStateClasses(Solver* S, lbool ret, vector<pair<int, int> >& literalToStateClass, int nStates, vector<int>& stateClass) {
+	stateClass.assign(nStates, -1);
+	for (unsigned int lit=1; lit<literalToStateClass.size() && (int)lit<=S->nVars(); lit++) {
+		pair<int, int>& sc = literalToStateClass[lit];
+		if (sc.first==-1) continue;
+		bool inClass = (ret == l_True) ? (S->model[lit-1] == l_True) : !S->getPolarity(lit-1);
+		if (inClass && (stateClass[sc.first]==-1 || sc.second<stateClass[sc.first])) stateClass[sc.first] = sc.second;
+	}
+}
+
+//sets the preferred polarities of the literals that assign states to classes: state s is preferably in class stateClass[s], and in no other class
+//(if stateClass[s] is -1 or not a class of the SAT problem, s is preferably in no class)
+void setStatePhases(Solver* S, vector<pair<int, int> >& literalToStateClass, vector<int>& stateClass) {
+	for (unsigned int lit=1; lit<literalToStateClass.size() && (int)lit<=S->nVars(); lit++) {
+		pair<int, int>& sc = literalToStateClass[lit];
+		if (sc.first==-1) continue;
+		//a polarity of true prefers the negative literal
+		S->setPolarity(lit-1, stateClass[sc.first]!=sc.second);
+	}
+}
+
+//builds and solves the SAT problem for nClasses classes
+//if it is satisfiable, satClasses, satSolver, and literalToStateClass are replaced by nClasses and the corresponding solver and literal map
+lbool solveForClasses(int nClasses, vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, int maxInput, int& satClasses, Solver*& satSolver, vector<pair<int, int> >& literalToStateClass, vector<int>& phaseHint) {
+	//no CNF is built after the timeout has expired
+	{
+		std::lock_guard<std::mutex> lock(runningSolversMutex);
+		if (timeoutExpired) return l_Undef;
+	}
+
+	if (verbosity>0) cout << "Classes: " << nClasses << endl;
+
+	vector<pair<int, int> > curLiteralToStateClass;
+
+	timeval start, end;
+	gettimeofday(&start, 0);
+
+	if (reusePhases && phaseHint.empty()) getGreedyStateClasses(nextStatesMap, incompMatrix, pairwiseIncStates, phaseHint);
+
+	Solver* S;
+	lbool ret;
+	if (portfolioSize>1) {
+		ret = solvePortfolio(nClasses, nextStatesMap, incompMatrix, pairwiseIncStates, maxInput, curLiteralToStateClass, phaseHint, S);
+
+		gettimeofday(&end, 0);
+		if (verbosity>0) cout << "Portfolio of " << portfolioSize << " solvers (building CNFs and solving): "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
+	} else {
+		S = newSolver();
+		encodeCNF(S, nClasses, nextStatesMap, incompMatrix, pairwiseIncStates, maxInput, curLiteralToStateClass, phaseHint);
+
+		gettimeofday(&end, 0);
+		if (verbosity>0) cout << "Building CNF: "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
+		gettimeofday(&start, 0);
 
 		vec<Lit> dummy;
-		lbool ret = S.solveLimited(dummy);
+		ret = solveWithLimits(*S, dummy);
 
-		gettimeofday(&end2, 0);
-		if (verbosity>0) cout << "Minisat: "<< (end2.tv_sec*1e6 + end2.tv_usec) - (start2.tv_sec*1e6 + start2.tv_usec) << " usec" << endl;
+		gettimeofday(&end, 0);
+		if (verbosity>0) cout << "Minisat: "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
+	}
 
-		if (verbosity>0) cout << (ret == l_True ? "SATISFIABLE\n" : ret == l_False ? "UNSATISFIABLE\n" : "INDETERMINATE\n");
+	if (verbosity>0) cout << (ret == l_True ? "SATISFIABLE\n" : ret == l_False ? "UNSATISFIABLE\n" : "INDETERMINATE\n");
 
-		if (verbosity>1) printStats(S);
+	if (verbosity>1 && S!=NULL) printStats(*S);
 
-		if (ret == l_True){
-			gettimeofday(&end, 0);
-			if (verbosity>0) cout << "Total time for SAT: "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
-			gettimeofday(&start, 0);
+	if (reusePhases && S!=NULL) getFinalStateClasses(S, ret, curLiteralToStateClass, nextStatesMap.size(), phaseHint);
+
+	if (ret != l_True) {
+		delete S;
+		return ret;
+	}
 
-			std::vector<int> dimacsOutput;
+	delete satSolver;
+	satSolver = S;
+	satClasses = nClasses;
+	literalToStateClass.swap(curLiteralToStateClass);
+	return ret;
+}
 
-			for (int i = 0; i < S.nVars(); i++) {
-				if (S.model[i] != l_Undef) {
-					int lit = i+1;
-					if (S.model[i]==l_False) lit = -lit;
-					dimacsOutput.push_back(lit);					}
+//searches for the smallest satisfiable number of classes between lowerBound and upperBound with the selected search strategy
+//all numbers of classes < lowerBound must be unsatisfiable, upperBound must be satisfiable; afterwards, this still holds, and lowerBound==upperBound
+//unless the timeout or a budget was reached (then true is returned); satClasses, satSolver, and literalToStateClass are updated as in solveForClasses
+bool searchClasses(int& lowerBound, int& upperBound, vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, int maxInput, int& satClasses, Solver*& satSolver, vector<pair<int, int> >& literalToStateClass, vector<int>& phaseHint) {
+	bool limitReached = false;
+
+	if (searchStrategy == SEARCH_LINEAR) {
+		while (lowerBound < upperBound && !limitReached) {
+			lbool ret = solveForClasses(lowerBound, nextStatesMap, incompMatrix, pairwiseIncStates, maxInput, satClasses, satSolver, literalToStateClass, phaseHint);
+			if (ret == l_True) {
+				upperBound = lowerBound;
+			} else if (ret == l_False) {
+				lowerBound++;
+			} else {
+				limitReached = true;
+			}
+		}
+	} else if (searchStrategy == SEARCH_DOWN) {
+		while (lowerBound < upperBound && !limitReached) {
+			lbool ret = solveForClasses(upperBound-1, nextStatesMap, incompMatrix, pairwiseIncStates, maxInput, satClasses, satSolver, literalToStateClass, phaseHint);
+			if (ret == l_True) {
+				upperBound--;
+			} else if (ret == l_False) {
+				lowerBound = upperBound;
+			} else {
+				limitReached = true;
 			}
+		}
+	} else {
+		if (searchStrategy == SEARCH_GALLOP) {
+			//probes lowerBound, lowerBound+1, lowerBound+3, lowerBound+7, ... until a satisfiable number of classes is found
+			int base = lowerBound;
+			for (int step=1; lowerBound < upperBound && !limitReached; step*=2) {
+				int nClasses = std::min(base+step-1, upperBound-1);
+				lbool ret = solveForClasses(nClasses, nextStatesMap, incompMatrix, pairwiseIncStates, maxInput, satClasses, satSolver, literalToStateClass, phaseHint);
+				if (ret == l_True) {
+					upperBound = nClasses;
+					break;
+				} else if (ret == l_False) {
+					lowerBound = nClasses+1;
+				} else {
+					limitReached = true;
+				}
+			}
+		}
 
-			int newResetState=-1;
+		while (lowerBound < upperBound && !limitReached) {
+			int nClasses = lowerBound + (upperBound-lowerBound)/2;
+			lbool ret = solveForClasses(nClasses, nextStatesMap, incompMatrix, pairwiseIncStates, maxInput, satClasses, satSolver, literalToStateClass, phaseHint);
+			if (ret == l_True) {
+				upperBound = nClasses;
+			} else if (ret == l_False) {
+				lowerBound = nClasses+1;
+			} else {
+				limitReached = true;
+			}
+		}
+	}
 
-			vector<vector<int> > newMachineNextStatesMap(nClasses);
-			vector<vector<IncSpecSeq*> > newMachineOutputsMap(nClasses);
-			buildMachine(newMachineNextStatesMap, newMachineOutputsMap, newResetState, nClasses, dimacsOutput, literalToStateClass, nextStatesMap, outputsMap, resetState, inputIDToIncSpecSeq.size()-1);
+	return limitReached;
+}
 
-			gettimeofday(&end, 0);
-			if (verbosity>0) cout << "Building machine: "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
-			gettimeofday(&start, 0);
+//configures solver i of a portfolio; solver 0 keeps the default configuration, the others differ in their random seed
+//and initial activities, and (cyclically) in the decision heuristic, the phase saving, the restarts, and the activity decay
+//this has to be done before the variables are created
+void diversifySolver(Solver* S, int i) {
+	if (i==0) return;
+	S->random_seed = 91648253 + 7919*i;
+	S->rnd_init_act = true;
+	switch (i%4) {
+	case 1:
+		S->random_var_freq = 0.01;
+		S->var_decay = 0.9;
+		break;
+	case 2:
+		S->luby_restart = false;
+		S->var_decay = 0.99;
+		break;
+	case 3:
+		S->phase_saving = 1;
+		S->lbd_mode = !S->lbd_mode;
+		break;
+	case 0:
+		S->rnd_pol = true;
+		S->phase_saving = 0;
+		S->random_var_freq = 0.02;
+		break;
+	}
+}
+
+//learnt units and binary clauses of the solvers of a portfolio; all solvers have the same CNF (and thus the same variables)
+//after each restart, a solver adds the clauses that the other solvers have learnt since its previous restart
+class SharedClauses : public ClauseSharing {
+public:
+	void exportClause(Solver& from, const vec<Lit>& c) {
+		std::lock_guard<std::mutex> lock(mutex);
+		clauses.push_back(make_pair(&from, vector<Lit>(c.size())));
+		for (int i=0; i<c.size(); i++) clauses.back().second[i] = c[i];
+	}
 
-			writeKISSFile(newMachineNextStatesMap, newMachineOutputsMap, newResetState, numInputBits, numOutputBits, inputIDToIncSpecSeq, "result.kiss");
+	void importClauses(Solver& to) {
+		std::lock_guard<std::mutex> lock(mutex);
+		unsigned int& next = nImported[&to];
+		for (; next<clauses.size(); next++) {
+			if (clauses[next].first==&to) continue;
+			vector<Lit>& c = clauses[next].second;
+			vec<Lit> ps;
+			for (unsigned int i=0; i<c.size(); i++) ps.push(c[i]);
+			if (!to.addClause(ps)) return;
+		}
+	}
 
-			gettimeofday(&end, 0);
-			if (verbosity>0) cout << "Writing to KISS file: "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
+private:
+	std::mutex mutex;
+	vector<pair<Solver*, vector<Lit> > > clauses;
+	map<Solver*, unsigned int> nImported;
+};
 
-			cout << "Result written to result.kiss" << endl;
-			exit(0);
+//the solvers of a portfolio; winner and result are protected by mutex
+struct Portfolio {
+	std::mutex mutex;
+	vector<Solver*> solvers;
+	vector<vector<pair<int, int> > > literalToStateClass;
+	//the first solver that found a definitive answer (-1 if there is none)
+	int winner;
+	lbool result;
+};
+
+//builds the CNF for solver i of the portfolio and solves it; the first definitive answer interrupts the other solvers
+void portfolioWorker(Portfolio* portfolio, int i, int nClasses, vector<vector<int> >* nextStatesMap, BitMatrix* incompMatrix, vector<int>* pairwiseIncStates, int maxInput, vector<int>* phaseHint) {
+	Solver* S = portfolio->solvers[i];
+	encodeCNF(S, nClasses, *nextStatesMap, *incompMatrix, *pairwiseIncStates, maxInput, portfolio->literalToStateClass[i], *phaseHint);
+
+	vec<Lit> dummy;
+	lbool ret = solveWithLimits(*S, dummy);
+	if (ret == l_Undef) return;
+
+	std::lock_guard<std::mutex> lock(portfolio->mutex);
+	if (portfolio->winner != -1) return;
+	portfolio->winner = i;
+	portfolio->result = ret;
+	for (unsigned int j=0; j<portfolio->solvers.size(); j++) {
+		if ((int)j!=i) portfolio->solvers[j]->interrupt();
+	}
+}
+
+//solves the SAT problem for nClasses classes with portfolioSize differently configured solvers, one per thread (--portfolio)
+//solver is set to the solver that found the answer (NULL if all solvers reached a limit), literalToStateClass to its literal map
+lbool solvePortfolio(int nClasses, vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, int maxInput, vector<pair<int, int> >& literalToStateClass, vector<int>& phaseHint, Solver*& solver) {
+	Portfolio portfolio;
+	portfolio.winner = -1;
+	portfolio.result = l_Undef;
+	portfolio.literalToStateClass.resize(portfolioSize);
+
+	SharedClauses sharedClauses;
+	for (int i=0; i<portfolioSize; i++) {
+		Solver* S = newSolver();
+		diversifySolver(S, i);
+		//eliminated variables differ between SimpSolvers, so their clauses cannot be exchanged
+		if (shareClauses && !simplifyCNF) S->clause_sharing = &sharedClauses;
+		portfolio.solvers.push_back(S);
+	}
+
+	vector<std::thread> threads;
+	for (int i=0; i<portfolioSize; i++) {
+		threads.push_back(std::thread(portfolioWorker, &portfolio, i, nClasses, &nextStatesMap, &incompMatrix, &pairwiseIncStates, maxInput, &phaseHint));
+	}
+	for (unsigned int i=0; i<threads.size(); i++) {
+		threads[i].join();
+	}
+
+	solver = NULL;
+	for (int i=0; i<portfolioSize; i++) {
+		if (i==portfolio.winner) {
+			solver = portfolio.solvers[i];
+			literalToStateClass.swap(portfolio.literalToStateClass[i]);
+		} else {
+			delete portfolio.solvers[i];
 		}
 	}
-	exit(0);
+	if (verbosity>0 && portfolio.winner!=-1) cout << "Portfolio: solver " << portfolio.winner << " answered first" << endl;
+	return portfolio.result;
+}
+
+//state of the parallel search over the number of classes; all members are protected by mutex
+struct ParallelClassSearch {
+	std::mutex mutex;
+	//smallest number of classes that has not been assigned to a thread yet
+	int nextClasses;
+	//the SAT problems for all numbers of classes <= maxUnsat are unsatisfiable
+	int maxUnsat;
+	//the SAT problem for minSat classes is satisfiable (minSatSolver is NULL if this is known from the upper bound)
+	int minSat;
+	Solver* minSatSolver;
+	vector<pair<int, int> > minSatLiteralToStateClass;
+	//solvers that are currently running, by their number of classes
+	map<int, Solver*> running;
+	//true if a SAT problem could not be solved because of the timeout or a budget
+	bool limitReached;
+};
+
+//repeatedly takes the next number of classes and solves the corresponding SAT problem
+//if a problem is satisfiable (unsatisfiable), the problems for all larger (smaller) numbers of classes are interrupted, as their results are no longer needed
+void solveClassesWorker(ParallelClassSearch* search, vector<vector<int> >* nextStatesMap, BitMatrix* incompMatrix, vector<int>* pairwiseIncStates, int maxInput) {
+	while (true) {
+		Solver* solver = newSolver();
+		int nClasses;
+		{
+			std::lock_guard<std::mutex> lock(search->mutex);
+			nClasses = std::max(search->nextClasses, search->maxUnsat+1);
+			if (nClasses >= search->minSat || search->limitReached) {
+				delete solver;
+				return;
+			}
+			search->nextClasses = nClasses+1;
+			search->running[nClasses] = solver;
+		}
+
+		timeval start, end;
+		gettimeofday(&start, 0);
+
+		vector<pair<int, int> > literalToStateClass;
+		vector<int> noPhaseHint;
+		encodeCNF(solver, nClasses, *nextStatesMap, *incompMatrix, *pairwiseIncStates, maxInput, literalToStateClass, noPhaseHint);
+
+		vec<Lit> dummy;
+		lbool ret = solveWithLimits(*solver, dummy);
+
+		gettimeofday(&end, 0);
+
+		std::lock_guard<std::mutex> lock(search->mutex);
+		search->running.erase(nClasses);
+
+		if (verbosity>0) cout << "Classes: " << nClasses << ": " << (ret == l_True ? "SATISFIABLE" : ret == l_False ? "UNSATISFIABLE" : "INTERRUPTED") << " ("<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec)" << endl;
+		if (verbosity>1 && ret != l_Undef) printStats(*solver);
+
+		if (ret == l_True && nClasses < search->minSat) {
+			search->minSat = nClasses;
+			delete search->minSatSolver;
+			search->minSatSolver = solver;
+			search->minSatLiteralToStateClass.swap(literalToStateClass);
+			for (map<int, Solver*>::iterator it=search->running.upper_bound(nClasses); it!=search->running.end(); it++) {
+				it->second->interrupt();
+			}
+		} else {
+			if (ret == l_Undef && nClasses > search->maxUnsat && nClasses < search->minSat && !search->limitReached) {
+				//the solver was not interrupted because its result was no longer needed, so the timeout or a budget was reached
+				search->limitReached = true;
+				for (map<int, Solver*>::iterator it=search->running.begin(); it!=search->running.end(); it++) {
+					it->second->interrupt();
+				}
+			}
+			if (ret == l_False && nClasses > search->maxUnsat) {
+				search->maxUnsat = nClasses;
+				for (map<int, Solver*>::iterator it=search->running.begin(); it!=search->running.end() && it->first<nClasses; it++) {
+					it->second->interrupt();
+				}
+			}
+			delete solver;
+		}
+	}
+}
+
+//solves the SAT problems for lowerBound, lowerBound+1, ..., upperBound-1 classes on nThreads threads, until the smallest satisfiable number of classes is found
+//returns the solver for this number of classes (stored in nClasses); returns NULL if all these problems are unsatisfiable (upperBound is assumed to be satisfiable)
+//if the timeout or a budget is reached, limitReached is set to true, the smallest satisfiable number of classes found so far is returned,
+//and provenLowerBound is set to the smallest number of classes that is not known to be unsatisfiable
+Solver* solveClassesInParallel(unsigned int lowerBound, int upperBound, vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& pairwiseIncStates, int maxInput, vector<pair<int, int> >& literalToStateClass, int& nClasses, bool& limitReached, int& provenLowerBound) {
+	ParallelClassSearch search;
+	search.nextClasses = lowerBound;
+	search.maxUnsat = (int)lowerBound-1;
+	search.minSat = upperBound;
+	search.minSatSolver = NULL;
+	search.limitReached = false;
+
+	vector<std::thread> threads;
+	for (int t=0; t<nThreads; t++) {
+		threads.push_back(std::thread(solveClassesWorker, &search, &nextStatesMap, &incompMatrix, &pairwiseIncStates, maxInput));
+	}
+	for (unsigned int t=0; t<threads.size(); t++) {
+		threads[t].join();
+	}
+
+	nClasses = search.minSat;
+	literalToStateClass.swap(search.minSatLiteralToStateClass);
+	limitReached = search.limitReached;
+	provenLowerBound = search.maxUnsat+1;
+	return search.minSatSolver;
+}
+
+bool hasTransitions(vector<int>& nextStates) {
+	for (unsigned int a=0; a<nextStates.size(); a++) {
+		if (nextStates[a]!=-1) return true;
+	}
+	return false;
+}
+
+//partitions the states into independent components: states in different components are incompatible (as they are not transitively compatible),
+//and no state has a successor in a different component; thus, the components can be minimized separately
+//states without transitions are compatible with all other states; they are not assigned to a component (component[s]==-1), but added to
+//each component that contains a predecessor (see solveComponents), as a state can be in several classes
+//component[s] is the component of state s; returns the number of components
+int getIndependentComponents(vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<int>& component) {
+	int nStates = nextStatesMap.size();
+	int nWords = incompMatrix.rowWords();
+
+	//each set of transitively compatible states is a tree of the union-find structure with the parent pointers componentParent
+	vector<int> componentParent(nStates, -1);
+	vector<uint64_t> unprocessedStates(nWords);
+	for (int s=0; s<nStates; s++) {
+		if (hasTransitions(nextStatesMap[s])) unprocessedStates[s/64] |= (uint64_t)1<<(s%64);
+	}
+	vector<uint64_t> compatibleStates(nWords);
+
+	for (int s=0; s<nStates; s++) {
+		if (!((unprocessedStates[s/64]>>(s%64))&1)) continue;
+		unprocessedStates[s/64] &= ~((uint64_t)1<<(s%64));
+		componentParent[s] = s;
+
+		queue<int> worklist;
+		worklist.push(s);
+		while (!worklist.empty()) {
+			int curS = worklist.front();
+			worklist.pop();
+
+			compatibleStates = unprocessedStates;
+			incompMatrix.andNotRow(curS, compatibleStates.data());
+
+			for (int i=BitMatrix::nextSetBit(compatibleStates.data(), nStates, 0); i!=-1; i=BitMatrix::nextSetBit(compatibleStates.data(), nStates, i+1)) {
+				worklist.push(i);
+				unprocessedStates[i/64] &= ~((uint64_t)1<<(i%64));
+				componentParent[i] = s;
+			}
+		}
+	}
+
+	//the sets of a state and its successors are merged
+	for (int s=0; s<nStates; s++) {
+		for (unsigned int a=0; a<nextStatesMap[s].size(); a++) {
+			int t = nextStatesMap[s][a];
+			if (t==-1 || componentParent[t]==-1) continue;
+
+			int r1 = s;
+			while (componentParent[r1]!=r1) r1 = componentParent[r1];
+			int r2 = t;
+			while (componentParent[r2]!=r2) r2 = componentParent[r2];
+			if (r1!=r2) componentParent[std::max(r1, r2)] = std::min(r1, r2);
+		}
+	}
+
+	int nComponents = 0;
+	component.assign(nStates, -1);
+	for (int s=0; s<nStates; s++) {
+		if (componentParent[s]==-1) continue;
+		int r = s;
+		while (componentParent[r]!=r) r = componentParent[r];
+		if (component[r]==-1) component[r] = nComponents++;
+		component[s] = component[r];
+	}
+	return nComponents;
+}
+
+//a component of the machine that is minimized separately; all states are numbered locally
+struct Component {
+	//states[i] is the number of state i in the original machine
+	vector<int> states;
+	vector<vector<int> > nextStatesMap;
+	BitMatrix incompMatrix;
+	vector<int> pairwiseIncStates;
+
+	//result: the pairs (state, class) of the reduced component, its number of classes, and the largest number of classes that is known to be unsatisfiable + 1
+	vector<pair<int, int> > stateClasses;
+	int nClasses;
+	int lowerBound;
+	bool limitReached;
+};
+
+//minimizes the component; the greedy partition is used as upper bound, and as result if the SAT solver does not find a smaller solution
+void minimizeComponent(Component& comp, int maxInput) {
+	vector<int> stateClass;
+	int heuristicClasses = computeGreedyPartition(comp.nextStatesMap, comp.incompMatrix, stateClass, limitByTimeout(-1));
+
+	int lowerBound = comp.pairwiseIncStates.size();
+	int upperBound = heuristicClasses;
+	vector<int> partialSolution;
+	if (!noPartialSolutionInSat) partialSolution = comp.pairwiseIncStates;
+
+	int satClasses = -1;
+	Solver* satSolver = NULL;
+	vector<pair<int, int> > literalToStateClass;
+	vector<int> phaseHint;
+	comp.limitReached = searchClasses(lowerBound, upperBound, comp.nextStatesMap, comp.incompMatrix, partialSolution, maxInput, satClasses, satSolver, literalToStateClass, phaseHint);
+
+	comp.stateClasses.clear();
+	if (satSolver!=NULL && satClasses<heuristicClasses) {
+		comp.nClasses = satClasses;
+		for (int i=0; i<satSolver->nVars(); i++) {
+			if (satSolver->model[i]!=l_True || i+1>=(int)literalToStateClass.size()) continue;
+			pair<int, int>& sc = literalToStateClass[i+1];
+			if (sc.first!=-1) comp.stateClasses.push_back(sc);
+		}
+	} else {
+		comp.nClasses = heuristicClasses;
+		for (unsigned int s=0; s<stateClass.size(); s++) comp.stateClasses.push_back(make_pair(s, stateClass[s]));
+	}
+	comp.lowerBound = lowerBound;
+	delete satSolver;
+
+	if (verbosity>0) cout << "Component with " << comp.states.size() << " states: " << comp.nClasses << " classes" << (comp.limitReached ? " (limit reached)" : "") << endl;
+}
+
+//repeatedly takes the next component and minimizes it
+void minimizeComponentsWorker(vector<Component>* components, std::atomic<int>* nextComponent, int maxInput) {
+	while (true) {
+		int c = (*nextComponent)++;
+		if (c >= (int)components->size()) return;
+		minimizeComponent((*components)[c], maxInput);
+	}
+}
+
+struct MoreStates {
+	bool operator()(const Component& c1, const Component& c2) const {
+		return c1.states.size() > c2.states.size();
+	}
+};
+
+//minimizes the components separately (on nThreads threads), and writes the union of the reduced components to result.kiss
+void solveComponents(vector<int>& component, int nComponents, vector<int>& pairwiseIncStates, vector<vector<int> >& nextStatesMap, BitMatrix& incompMatrix, vector<vector<IncSpecSeq*> >& outputsMap, int resetState, int numInputBits, int numOutputBits, vector<IncSpecSeq>& inputIDToIncSpecSeq) {
+	int nStates = nextStatesMap.size();
+
+	vector<Component> components(std::max(nComponents, 1));
+	for (int s=0; s<nStates; s++) {
+		if (component[s]!=-1) components[component[s]].states.push_back(s);
+	}
+
+	//states without transitions are added to the components of their predecessors (or to the first component if they have no predecessors)
+	vector<int> lastComponent(nStates, -1);
+	for (int s=0; s<nStates; s++) {
+		if (component[s]==-1) continue;
+		for (unsigned int a=0; a<nextStatesMap[s].size(); a++) {
+			int t = nextStatesMap[s][a];
+			if (t==-1 || component[t]!=-1 || lastComponent[t]==component[s]) continue;
+			components[component[s]].states.push_back(t);
+			lastComponent[t] = component[s];
+		}
+	}
+	for (int s=0; s<nStates; s++) {
+		if (component[s]==-1 && lastComponent[s]==-1) components[0].states.push_back(s);
+	}
+
+	//large components are started first
+	std::stable_sort(components.begin(), components.end(), MoreStates());
+
+	vector<int> localNumber(nStates, -1);
+	for (unsigned int c=0; c<components.size(); c++) {
+		Component& comp = components[c];
+		unsigned int n = comp.states.size();
+		for (unsigned int i=0; i<n; i++) localNumber[comp.states[i]] = i;
+
+		comp.nextStatesMap.resize(n);
+		comp.incompMatrix.resize(n, n);
+		for (unsigned int i=0; i<n; i++) {
+			vector<int>& origNextStates = nextStatesMap[comp.states[i]];
+			vector<int>& newNextStates = comp.nextStatesMap[i];
+			newNextStates.resize(origNextStates.size());
+			for (unsigned int a=0; a<origNextStates.size(); a++) {
+				newNextStates[a] = (origNextStates[a]==-1 ? -1 : localNumber[origNextStates[a]]);
+			}
+
+			for (unsigned int j=0; j<n; j++) {
+				if (incompMatrix.get(comp.states[i], comp.states[j])) comp.incompMatrix.set(i, j);
+			}
+		}
+
+		//the restriction of the pairwise incompatible states to the component, unless the greedy heuristic finds more in the component
+		if (!noLowerBound) {
+			for (unsigned int i=0; i<pairwiseIncStates.size(); i++) {
+				if (localNumber[pairwiseIncStates[i]]!=-1) comp.pairwiseIncStates.push_back(localNumber[pairwiseIncStates[i]]);
+			}
+			vector<int> localPairwiseIncStates;
+			findPairwiseIncStates(localPairwiseIncStates, comp.incompMatrix, n);
+			if (localPairwiseIncStates.size() > comp.pairwiseIncStates.size()) comp.pairwiseIncStates.swap(localPairwiseIncStates);
+		}
+
+		for (unsigned int i=0; i<n; i++) localNumber[comp.states[i]] = -1;
+	}
+
+	std::atomic<int> nextComponent(0);
+	int maxInput = inputIDToIncSpecSeq.size()-1;
+	vector<std::thread> threads;
+	for (int t=0; t<nThreads; t++) {
+		threads.push_back(std::thread(minimizeComponentsWorker, &components, &nextComponent, maxInput));
+	}
+	for (unsigned int t=0; t<threads.size(); t++) {
+		threads[t].join();
+	}
+
+	//the classes of the components are numbered consecutively; each literal assigns a state to a class
+	vector<int> dimacsOutput;
+	vector<pair<int, int> > literalToStateClass(1, make_pair(-1, -1));
+	int nClasses = 0;
+	int lowerBound = 0;
+	bool limitReached = false;
+	for (unsigned int c=0; c<components.size(); c++) {
+		Component& comp = components[c];
+		for (unsigned int i=0; i<comp.stateClasses.size(); i++) {
+			literalToStateClass.push_back(make_pair(comp.states[comp.stateClasses[i].first], nClasses + comp.stateClasses[i].second));
+			dimacsOutput.push_back(literalToStateClass.size()-1);
+		}
+		nClasses += comp.nClasses;
+		lowerBound += comp.lowerBound;
+		limitReached = limitReached || comp.limitReached;
+	}
+
+	if (limitReached) cout << "Limit reached; the result is not necessarily minimal" << endl;
+
+	writeMachine(dimacsOutput, literalToStateClass, nClasses, nextStatesMap, outputsMap, resetState, numInputBits, numOutputBits, inputIDToIncSpecSeq);
+	cout << "Result written to result.kiss" << endl;
+
+	if (limitReached) cout << "States: " << nClasses << ", lower bound: " << lowerBound << endl;
+}
+
+//builds the reduced machine from the model of the solver, and writes it to result.kiss
+void writeResult(Solver& S, vector<pair<int, int> >& literalToStateClass, int nClasses, vector<vector<int> >& nextStatesMap, vector<vector<IncSpecSeq*> >& outputsMap, int resetState, int numInputBits, int numOutputBits, vector<IncSpecSeq>& inputIDToIncSpecSeq) {
+	std::vector<int> dimacsOutput;
+
+	for (int i = 0; i < S.nVars(); i++) {
+		if (S.model[i] != l_Undef) {
+			int lit = i+1;
+			if (S.model[i]==l_False) lit = -lit;
+			dimacsOutput.push_back(lit);
+		}
+	}
+
+	writeMachine(dimacsOutput, literalToStateClass, nClasses, nextStatesMap, outputsMap, resetState, numInputBits, numOutputBits, inputIDToIncSpecSeq);
+
+	cout << "Result written to result.kiss" << endl;
+}
+
+//called if the SAT solver was stopped by the timeout or a budget; all numbers of classes < lowerBound are known to be unsatisfiable
+//writes the best solution that has been found so far to result.kiss (i.e., the model of satSolver, the preliminary result, or the original machine)
+void writeLimitResult(int lowerBound, Solver* satSolver, vector<pair<int, int> >& literalToStateClass, int satClasses, int heuristicClasses, vector<vector<int> >& nextStatesMap, vector<vector<IncSpecSeq*> >& outputsMap, int resetState, int numInputBits, int numOutputBits, vector<IncSpecSeq>& inputIDToIncSpecSeq) {
+	cout << "Limit reached; the result is not necessarily minimal" << endl;
+
+	int bestClasses;
+	if (satSolver!=NULL && satClasses<heuristicClasses) {
+		bestClasses = satClasses;
+		writeResult(*satSolver, literalToStateClass, satClasses, nextStatesMap, outputsMap, resetState, numInputBits, numOutputBits, inputIDToIncSpecSeq);
+	} else if (heuristicClasses!=INT_MAX) {
+		bestClasses = heuristicClasses;
+		cout << "Result written to result.kiss" << endl;
+	} else {
+		bestClasses = nextStatesMap.size();
+		vector<int> stateClass(nextStatesMap.size());
+		for (unsigned int s=0; s<stateClass.size(); s++) stateClass[s] = s;
+		writePartitionResult(stateClass, bestClasses, nextStatesMap, outputsMap, resetState, numInputBits, numOutputBits, inputIDToIncSpecSeq);
+	}
+
+	cout << "States: " << bestClasses << ", lower bound: " << lowerBound << endl;
+}
+
+//writes the machine that is obtained by merging the states of each class to result.kiss; stateClass[s] is the class of state s
+void writePartitionResult(vector<int>& stateClass, int nClasses, vector<vector<int> >& nextStatesMap, vector<vector<IncSpecSeq*> >& outputsMap, int resetState, int numInputBits, int numOutputBits, vector<IncSpecSeq>& inputIDToIncSpecSeq) {
+	//literal s+1 assigns state s to its class
+	vector<int> dimacsOutput(stateClass.size());
+	vector<pair<int, int> > literalToStateClass(stateClass.size()+1, make_pair(-1, -1));
+	for (unsigned int s=0; s<stateClass.size(); s++) {
+		dimacsOutput[s] = s+1;
+		literalToStateClass[s+1] = make_pair(s, stateClass[s]);
+	}
+
+	writeMachine(dimacsOutput, literalToStateClass, nClasses, nextStatesMap, outputsMap, resetState, numInputBits, numOutputBits, inputIDToIncSpecSeq);
+
+	cout << "Preliminary result with " << nClasses << " states written to result.kiss" << endl;
+}
+
+//builds the reduced machine from a satisfying assignment (in DIMACS format), and writes it to result.kiss
+void writeMachine(vector<int>& dimacsOutput, vector<pair<int, int> >& literalToStateClass, int nClasses, vector<vector<int> >& nextStatesMap, vector<vector<IncSpecSeq*> >& outputsMap, int resetState, int numInputBits, int numOutputBits, vector<IncSpecSeq>& inputIDToIncSpecSeq) {
+	timeval start, end;
+	gettimeofday(&start, 0);
+
+	int newResetState=-1;
+
+	vector<vector<int> > newMachineNextStatesMap(nClasses);
+	vector<vector<IncSpecSeq*> > newMachineOutputsMap(nClasses);
+	buildMachine(newMachineNextStatesMap, newMachineOutputsMap, newResetState, nClasses, dimacsOutput, literalToStateClass, nextStatesMap, outputsMap, resetState, inputIDToIncSpecSeq.size()-1);
+
+	gettimeofday(&end, 0);
+	if (verbosity>0) cout << "Building machine: "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
+	gettimeofday(&start, 0);
+
+	writeKISSFile(newMachineNextStatesMap, newMachineOutputsMap, newResetState, numInputBits, numOutputBits, inputIDToIncSpecSeq, "result.kiss");
+
+	gettimeofday(&end, 0);
+	if (verbosity>0) cout << "Writing to KISS file: "<< (end.tv_sec*1e6 + end.tv_usec) - (start.tv_sec*1e6 + start.tv_usec) << " usec" << endl;
 }
 
 void removeUnreachableStates(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& machine, int& resetState) {
@@ -270,102 +1494,154 @@ void removeUnreachableStates(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSe
 	resetState = stateRemapping[resetState];
 }
 
-void computePredecessorMap(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, unordered_map<IncSpecSeq*,vector<int> > pred[]) {
-	for (unsigned int s=0; s<states.size(); s++) {
-		vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > >& tMap = states[s];
-		for (vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > >::iterator it=tMap.begin(); it!=tMap.end(); ++it) {
-			IncSpecSeq* input = it->first;
-			pair<int, IncSpecSeq*>& p = it->second;
-			int nextS = p.first;
+//propagates the incompatibility of s1 and s2 backwards to all pairs of predecessors with overlapping inputs, until a fixpoint is reached
+//worklist is only used as a buffer (to avoid reallocations); returns the number of incompatible pairs that were processed
+unsigned long long propagateIncompStates(int s1, int s2, PredecessorIndex& pred, BitMatrix& inputsOverlap, BitMatrix& incompMatrix, vector<pair<int, int> >& worklist) {
+	unsigned long long nProcessedPairs = 0;
 
-			pred[nextS][input].push_back(s);
-		}
-	}
-}
+	worklist.clear();
+	worklist.push_back(make_pair(s1, s2));
 
-void propagateIncompStates(int s1, int s2, int nStates, unordered_map<IncSpecSeq*,vector<int> > pred[], vector<bool>& incompMatrix) {
-	unordered_map<IncSpecSeq*,vector<int> >& pred1 = pred[s1];
-	unordered_map<IncSpecSeq*,vector<int> >& pred2 = pred[s2];
+	while (!worklist.empty()) {
+		pair<int, int> curPair = worklist.back();
+		worklist.pop_back();
+		nProcessedPairs++;
 
-	for (unordered_map<IncSpecSeq*,vector<int> >::iterator it1=pred1.begin(); it1!=pred1.end(); it1++) {
-		const IncSpecSeq& input1 = *(it1->first);
-		vector<int>& predStates1 = it1->second;
+		int groupsEnd1 = pred.groupStart[curPair.first+1];
+		int groupsEnd2 = pred.groupStart[curPair.second+1];
 
-		for (unordered_map<IncSpecSeq*,vector<int> >::iterator it2=pred2.begin(); it2!=pred2.end(); it2++) {
-			const IncSpecSeq& input2 = *(it2->first);
+		for (int g1=pred.groupStart[curPair.first]; g1<groupsEnd1; g1++) {
+			int input1 = pred.groupInput[g1];
 
-			if (input1.isDisjoint(input2)) continue;
+			for (int g2=pred.groupStart[curPair.second]; g2<groupsEnd2; g2++) {
+				int input2 = pred.groupInput[g2];
 
-			vector<int>& predStates2 = it2->second;
+				if (!inputsOverlap.get(input1, input2)) continue;
 
-			for (unsigned int i1 = 0; i1<predStates1.size(); i1++) {
-				int predS1 = predStates1[i1];
-				for (unsigned int i2 = 0; i2<predStates2.size(); i2++) {
-					int predS2 = predStates2[i2];
-					if (incompMatrix[ai(predS1,predS2,nStates)]) continue;
+				for (int i1=pred.predStart[g1]; i1<pred.predStart[g1+1]; i1++) {
+					int predS1 = pred.predStates[i1];
+					for (int i2=pred.predStart[g2]; i2<pred.predStart[g2+1]; i2++) {
+						int predS2 = pred.predStates[i2];
+						if (incompMatrix.get(predS1, predS2)) continue;
 
-					incompMatrix[ai(predS1,predS2,nStates)]=true;
-					incompMatrix[ai(predS2,predS1,nStates)]=true;
-					propagateIncompStates(predS1, predS2, nStates, pred, incompMatrix);
+						incompMatrix.set(predS1, predS2);
+						incompMatrix.set(predS2, predS1);
+						worklist.push_back(make_pair(predS1, predS2));
+					}
 				}
 			}
 		}
 	}
+
+	return nProcessedPairs;
 }
 
-void computeIncompMatrix(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, unordered_map<IncSpecSeq*,vector<int> > pred[], vector<bool>& incompMatrix) {
-	int nStates = states.size();
+//two states are directly incompatible if they have transitions with overlapping inputs and incompatible outputs
+bool directlyIncompatible(int s1, int s2, TransitionIndex& trans, BitMatrix& inputsOverlap) {
+	for (int t1=trans.transStart[s1]; t1<trans.transStart[s1+1]; t1++) {
+		int input1 = trans.transInput[t1];
+		IncSpecSeq* o1 = trans.transOutput[t1];
 
-	for (int s1=0; s1<nStates; s1++) {
-		vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > >& succMap1 = states[s1];
-		for (int s2=s1; s2<nStates; s2++) {
-			if (incompMatrix[ai(s1,s2,nStates)]) continue;
+		for (int t2=trans.transStart[s2]; t2<trans.transStart[s2+1]; t2++) {
+			if (!inputsOverlap.get(input1, trans.transInput[t2])) continue;
 
-			vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > >& succMap2 = states[s2];
+			//outputs are interned by the parser
+			IncSpecSeq* o2 = trans.transOutput[t2];
+			if (o1==o2) continue;
 
-			for (vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > >::iterator it1=succMap1.begin(); it1!=succMap1.end(); ++it1) {
-				const IncSpecSeq& input1 = *(it1->first);
+			if (!o1->isCompatible(*o2)) return true;
+		}
+	}
+	return false;
+}
 
-				bool incompOutputFound = false;
-				for (vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > >::iterator it2=succMap2.begin(); it2!=succMap2.end(); ++it2) {
-					const IncSpecSeq& input2 = *(it2->first);
+//number of rows of the state-pair triangle that a thread processes at once
+const int DIRECT_INCOMP_BLOCK_SIZE = 32;
 
-					if (input1.isDisjoint(input2)) continue;
+//sets directIncompMatrix[s1][s2] (s1<=s2) for all directly incompatible states;
+//the blocks of rows are distributed dynamically among the threads, and each thread only writes to its own rows
+void computeDirectIncompStates(TransitionIndex* trans, BitMatrix* inputsOverlap, BitMatrix* directIncompMatrix, std::atomic<int>* nextBlock) {
+	int nStates = directIncompMatrix->rows();
 
-					pair<int, IncSpecSeq*>& p1 = it1->second;
-					pair<int, IncSpecSeq*>& p2 = it2->second;
+	while (true) {
+		int blockStart = (nextBlock->fetch_add(1))*DIRECT_INCOMP_BLOCK_SIZE;
+		if (blockStart>=nStates) break;
+		int blockEnd = std::min(nStates, blockStart+DIRECT_INCOMP_BLOCK_SIZE);
 
-					IncSpecSeq& o1 = *(p1.second);
-					IncSpecSeq& o2 = *(p2.second);
+		for (int s1=blockStart; s1<blockEnd; s1++) {
+			for (int s2=s1; s2<nStates; s2++) {
+				if (directlyIncompatible(s1, s2, *trans, *inputsOverlap)) directIncompMatrix->set(s1, s2);
+			}
+		}
+	}
+}
 
-					if (o1.isCompatible(o2)) continue;
+//returns the number of incompatible pairs that were processed during the propagation
+unsigned long long computeIncompMatrix(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, PredecessorIndex& pred, BitMatrix& inputsOverlap, BitMatrix& incompMatrix) {
+	int nStates = states.size();
+	unsigned long long nProcessedPairs = 0;
+	vector<pair<int, int> > worklist;
 
-					incompMatrix[ai(s1,s2,nStates)]=true;
-					incompMatrix[ai(s2,s1,nStates)]=true;
+	TransitionIndex trans;
+	trans.build(states);
 
-					propagateIncompStates(s1, s2, nStates, pred, incompMatrix);
+	if (nThreads<=1) {
+		for (int s1=0; s1<nStates; s1++) {
+			for (int s2=s1; s2<nStates; s2++) {
+				if (incompMatrix.get(s1, s2)) continue;
+				if (!directlyIncompatible(s1, s2, trans, inputsOverlap)) continue;
 
-					incompOutputFound=true;
-					break;
-				}
-				if (incompOutputFound) break;
+				incompMatrix.set(s1, s2);
+				incompMatrix.set(s2, s1);
+
+				nProcessedPairs += propagateIncompStates(s1, s2, pred, inputsOverlap, incompMatrix, worklist);
 			}
 		}
+		return nProcessedPairs;
+	}
+
+	//first, all directly incompatible pairs are computed in parallel; then, the incompatibilities are propagated sequentially
+	BitMatrix directIncompMatrix(nStates, nStates);
+	std::atomic<int> nextBlock(0);
+
+	vector<std::thread> threads;
+	for (int t=0; t<nThreads; t++) {
+		threads.push_back(std::thread(computeDirectIncompStates, &trans, &inputsOverlap, &directIncompMatrix, &nextBlock));
+	}
+	for (int t=0; t<nThreads; t++) {
+		threads[t].join();
 	}
+
+	for (int s1=0; s1<nStates; s1++) {
+		for (int s2=directIncompMatrix.nextSetBit(s1, s1); s2!=-1; s2=directIncompMatrix.nextSetBit(s1, s2+1)) {
+			if (incompMatrix.get(s1, s2)) continue;
+
+			incompMatrix.set(s1, s2);
+			incompMatrix.set(s2, s1);
+
+			nProcessedPairs += propagateIncompStates(s1, s2, pred, inputsOverlap, incompMatrix, worklist);
+		}
+	}
+
+	return nProcessedPairs;
 }
 
 //partitions the set of states into equivalence classes, s.t. two states are in the same class if they are transitively compatible
 //ret[i][s]==true iff state s is in class i
-vector<vector<bool> > getTransitivelyCompatibleStates(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, vector<bool>& incompMatrix) {
+vector<vector<bool> > getTransitivelyCompatibleStates(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, BitMatrix& incompMatrix) {
 	vector<vector<bool> > ret;
 
 	int nStates = states.size();
-	vector<bool> processedStates;
-	processedStates.resize(nStates, false);
+	int nWords = incompMatrix.rowWords();
+
+	//bit s is 1 iff state s has not been assigned to a class yet
+	vector<uint64_t> unprocessedStates(nWords);
+	BitMatrix::setFirstBits(unprocessedStates.data(), nStates);
+	vector<uint64_t> compatibleStates(nWords);
 
 	for (int s=0; s<nStates; s++) {
-		if (processedStates[s]) continue;
-		processedStates[s] = true;
+		if (!((unprocessedStates[s/64]>>(s%64))&1)) continue;
+		unprocessedStates[s/64] &= ~((uint64_t)1<<(s%64));
 
 		vector<bool> curSet;
 		curSet.resize(nStates, 0);
@@ -378,12 +1654,13 @@ vector<vector<bool> > getTransitivelyCompatibleStates(vector<vector<pair<IncSpec
 			int curS = worklist.front();
 			worklist.pop();
 
-			for (int i=s; i<nStates; i++) {
-				if (processedStates[i]) continue;
-				if (incompMatrix[ai(curS,i,nStates)]) continue;
+			//unprocessed states that are compatible with curS
+			compatibleStates = unprocessedStates;
+			incompMatrix.andNotRow(curS, compatibleStates.data());
 
+			for (int i=BitMatrix::nextSetBit(compatibleStates.data(), nStates, 0); i!=-1; i=BitMatrix::nextSetBit(compatibleStates.data(), nStates, i+1)) {
 				worklist.push(i);
-				processedStates[i] = true;
+				unprocessedStates[i/64] &= ~((uint64_t)1<<(i%64));
 				curSet[i]=true;
 			}
 		}
@@ -394,7 +1671,7 @@ vector<vector<bool> > getTransitivelyCompatibleStates(vector<vector<pair<IncSpec
 }
 
 //compatible states must not have transitions with overlapping inputs
-void splitTransitions(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, vector<bool>& incompMatrix, vector<vector<int> >& newNextStates, vector<vector<IncSpecSeq*> >& newOutput, vector<IncSpecSeq>& inputIDToIncSpecSeq) {
+void splitTransitions(vector<vector<pair<IncSpecSeq*, pair<int, IncSpecSeq*> > > >& states, BitMatrix& incompMatrix, vector<vector<int> >& newNextStates, vector<vector<IncSpecSeq*> >& newOutput, vector<IncSpecSeq>& inputIDToIncSpecSeq) {
 	vector<vector<bool> > tcs = getTransitivelyCompatibleStates(states, incompMatrix);
 
 	vector<unordered_set<IncSpecSeq> >  disjInputsForTCS(tcs.size());
@@ -571,14 +1848,10 @@ unordered_set<IncSpecSeq> getDisjointInputSet(vector<vector<pair<IncSpecSeq*, pa
 class incStateComp {
 	int* nIncomp;
 public:
-	incStateComp(vector<bool>& incompMatrix, int nStates) {
+	incStateComp(BitMatrix& incompMatrix, int nStates) {
 		nIncomp = new int[nStates];
 		for (int i=0; i<nStates; i++) {
-			int c=0;
-			for (int j=0; j<nStates; j++) {
-				if (incompMatrix[ai(i,j,nStates)]) c++;
-			}
-			nIncomp[i]=c;
+			nIncomp[i]=incompMatrix.countRow(i);
 		}
 	}
 
@@ -587,7 +1860,7 @@ public:
 	}
 };
 
-void findPairwiseIncStates(vector<int>& pairwiseIncStates, vector<bool>& incompMatrix, int nStates) {
+void findPairwiseIncStates(vector<int>& pairwiseIncStates, BitMatrix& incompMatrix, int nStates) {
 	incStateComp comp(incompMatrix, nStates);
 
 	vector<int> states;
@@ -597,17 +1870,14 @@ void findPairwiseIncStates(vector<int>& pairwiseIncStates, vector<bool>& incompM
 
 	sort(states.begin(), states.end(), comp);
 
+	//bit s is 1 iff state s is incompatible with all states in pairwiseIncStates
+	vector<uint64_t> candidates(incompMatrix.rowWords());
+	BitMatrix::setFirstBits(candidates.data(), nStates);
+
 	for (int i=0; i<nStates; i++) {
 		int s1 = states[i];
-		bool compStateFound = false;
-		for (unsigned int j=0; j<pairwiseIncStates.size(); j++) {
-			int s2 = pairwiseIncStates[j];
-			if (!incompMatrix[ai(s1,s2,nStates)]) {
-				compStateFound = true;
-				break;
-			}
-		}
-		if (compStateFound) continue;
+		if (!((candidates[s1/64]>>(s1%64))&1)) continue;
 		pairwiseIncStates.push_back(s1);
+		incompMatrix.andRow(s1, candidates.data());
 	}
 }
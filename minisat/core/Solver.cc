@@ -41,6 +41,10 @@ static BoolOption    opt_rnd_init_act      (_cat, "rnd-init",    "Randomize the
 static BoolOption    opt_luby_restart      (_cat, "luby",        "Use the Luby restart sequence", true);
 static IntOption     opt_restart_first     (_cat, "rfirst",      "The base restart interval", 100, IntRange(1, INT32_MAX));
 static DoubleOption  opt_restart_inc       (_cat, "rinc",        "Restart interval increase factor", 2, DoubleRange(1, false, HUGE_VAL, false));
+static BoolOption    opt_lbd_mode          (_cat, "lbd",         "Keep learnt clauses with small LBD and restart dynamically (Glucose-style)", false);
+static IntOption     opt_lbd_glue          (_cat, "lbd-glue",    "Learnt clauses with at most this LBD are never removed (with -lbd)", 2, IntRange(0, INT32_MAX));
+static DoubleOption  opt_restart_margin    (_cat, "rmargin",     "Restart if the fast average LBD exceeds the slow one by this factor (with -lbd)", 1.25, DoubleRange(1, true, HUGE_VAL, false));
+static DoubleOption  opt_restart_block     (_cat, "rblock",      "Postpone restarts if the trail exceeds its average size by this factor (with -lbd)", 1.4, DoubleRange(1, true, HUGE_VAL, false));
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.20, DoubleRange(0, false, HUGE_VAL, false));
 
 
@@ -75,6 +79,15 @@ Solver::Solver() :
   , learntsize_adjust_start_confl (100)
   , learntsize_adjust_inc         (1.5)
 
+  , lbd_mode          (opt_lbd_mode)
+  , lbd_glue          (opt_lbd_glue)
+  , first_reduce_db   (2000)
+  , inc_reduce_db     (300)
+  , restart_min_confl (50)
+  , restart_margin    (opt_restart_margin)
+  , restart_block     (opt_restart_block)
+  , clause_sharing    (NULL)
+
     // Statistics: (formerly in 'SolverStats')
     //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0)
@@ -91,6 +104,14 @@ Solver::Solver() :
   , progress_estimate  (0)
   , remove_satisfied   (true)
 
+  , lbd_stamp_cnt      (0)
+  , lbd_samples        (0)
+  , lbd_ema_fast       (0)
+  , lbd_ema_slow       (0)
+  , trail_ema          (0)
+  , next_reduce_db     (0)
+  , reduce_db_cnt      (0)
+
     // Resource constraints:
     //
   , conflict_budget    (-1)
@@ -275,9 +296,17 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
         assert(confl != CRef_Undef); // (otherwise should be UIP)
         Clause& c = ca[confl];
 
-        if (c.learnt())
+        if (c.learnt()){
             claBumpActivity(c);
 
+            // Clauses that take part in conflicts get the (possibly smaller) LBD of the current assignment:
+            if (lbd_mode && c.lbd() > (uint32_t)lbd_glue){
+                uint32_t lbd = computeLBD(c);
+                if (lbd < c.lbd())
+                    c.lbd() = lbd;
+            }
+        }
+
         for (int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++){
             Lit q = c[j];
 
@@ -356,6 +385,21 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
 }
 
 
+// Exponential moving averages of the LBDs with smoothing factors 1/32 (fast) and 1/4096 (slow), and
+// of the trail size with smoothing factor 1/4096. The first values are averaged uniformly, so that the
+// slow averages are not biased towards 0 at the beginning of the search.
+//
+void Solver::updateLBDAverages(uint32_t lbd)
+{
+    lbd_samples++;
+    double alpha_fast = lbd_samples < 32   ? 1.0 / lbd_samples : 1.0 / 32;
+    double alpha_slow = lbd_samples < 4096 ? 1.0 / lbd_samples : 1.0 / 4096;
+    lbd_ema_fast += alpha_fast * (lbd - lbd_ema_fast);
+    lbd_ema_slow += alpha_slow * (lbd - lbd_ema_slow);
+    trail_ema    += alpha_slow * (trail.size() - trail_ema);
+}
+
+
 // Check if 'p' can be removed. 'abstract_levels' is used to abort early if the algorithm is
 // visiting literals at levels that cannot be removed later.
 bool Solver::litRedundant(Lit p, uint32_t abstract_levels)
@@ -522,9 +566,35 @@ struct reduceDB_lt {
     bool operator () (CRef x, CRef y) { 
         return ca[x].size() > 2 && (ca[y].size() == 2 || ca[x].activity() < ca[y].activity()); } 
 };
+struct reduceDB_lbd_lt {
+    ClauseAllocator& ca;
+    reduceDB_lbd_lt(ClauseAllocator& ca_) : ca(ca_) {}
+    bool operator () (CRef x, CRef y) {
+        if (ca[x].size() == 2) return false;
+        if (ca[y].size() == 2) return true;
+        if (ca[x].lbd() != ca[y].lbd()) return ca[x].lbd() > ca[y].lbd();
+        return ca[x].activity() < ca[y].activity(); }
+};
 void Solver::reduceDB()
 {
     int     i, j;
+
+    if (lbd_mode){
+        // Delete half of the clauses, starting with those with the largest LBD. Clauses with an LBD of at
+        // most 'lbd_glue' ("glue clauses") are kept permanently, as well as binary and locked clauses:
+        sort(learnts, reduceDB_lbd_lt(ca));
+        for (i = j = 0; i < learnts.size(); i++){
+            Clause& c = ca[learnts[i]];
+            if (i < learnts.size() / 2 && c.size() > 2 && c.lbd() > (uint32_t)lbd_glue && !locked(c))
+                removeClause(learnts[i]);
+            else
+                learnts[j++] = learnts[i];
+        }
+        learnts.shrink(i - j);
+        checkGarbage();
+        return;
+    }
+
     double  extra_lim = cla_inc / learnts.size();    // Remove any clause below this activity
 
     sort(learnts, reduceDB_lt(ca));
@@ -616,6 +686,7 @@ lbool Solver::search(int nof_conflicts)
     assert(ok);
     int         backtrack_level;
     int         conflictC = 0;
+    int         lbd_conflictC = 0;  // Conflicts since the last restart or blocked restart (in 'lbd_mode').
     vec<Lit>    learnt_clause;
     starts++;
 
@@ -623,17 +694,29 @@ lbool Solver::search(int nof_conflicts)
         CRef confl = propagate();
         if (confl != CRef_Undef){
             // CONFLICT
-            conflicts++; conflictC++;
+            conflicts++; conflictC++; lbd_conflictC++;
             if (decisionLevel() == 0) return l_False;
 
             learnt_clause.clear();
             analyze(confl, learnt_clause, backtrack_level);
+            uint32_t lbd = lbd_mode ? computeLBD(learnt_clause) : 0;
+            if (lbd_mode){
+                // Block LBD restarts if the assignment is much larger than usual (the solver might be close to a model);
+                // the Luby bound is not affected:
+                if (lbd_samples >= 4096 && trail.size() > restart_block * trail_ema)
+                    lbd_conflictC = 0;
+                updateLBDAverages(lbd);
+            }
             cancelUntil(backtrack_level);
 
+            if (clause_sharing != NULL && learnt_clause.size() <= 2)
+                clause_sharing->exportClause(*this, learnt_clause);
+
             if (learnt_clause.size() == 1){
                 uncheckedEnqueue(learnt_clause[0]);
             }else{
                 CRef cr = ca.alloc(learnt_clause, true);
+                if (lbd_mode) ca[cr].lbd() = lbd;
                 learnts.push(cr);
                 attachClause(cr);
                 claBumpActivity(ca[cr]);
@@ -657,7 +740,11 @@ lbool Solver::search(int nof_conflicts)
 
         }else{
             // NO CONFLICT
-            if (nof_conflicts >= 0 && conflictC >= nof_conflicts || !withinBudget()){
+            // In 'lbd_mode', the solver restarts early if the recent LBDs are large compared to the long-term average.
+            // If the LBDs hardly vary, this never happens, so the restart interval is still bounded by 'nof_conflicts':
+            bool restart = nof_conflicts >= 0 && conflictC >= nof_conflicts
+                        || lbd_mode && lbd_conflictC >= restart_min_confl && lbd_ema_fast > restart_margin * lbd_ema_slow;
+            if (restart || !withinBudget()){
                 // Reached bound on number of conflicts:
                 progress_estimate = progressEstimate();
                 cancelUntil(0);
@@ -667,9 +754,12 @@ lbool Solver::search(int nof_conflicts)
             if (decisionLevel() == 0 && !simplify())
                 return l_False;
 
-            if (learnts.size()-nAssigns() >= max_learnts)
+            if (lbd_mode ? conflicts >= next_reduce_db : learnts.size()-nAssigns() >= max_learnts){
                 // Reduce the set of learnt clauses:
                 reduceDB();
+                if (lbd_mode)
+                    next_reduce_db = conflicts + first_reduce_db + (uint64_t)inc_reduce_db * ++reduce_db_cnt;
+            }
 
             Lit next = lit_Undef;
             while (decisionLevel() < assumptions.size()){
@@ -760,6 +850,10 @@ lbool Solver::solve_()
     learntsize_adjust_confl   = learntsize_adjust_start_confl;
     learntsize_adjust_cnt     = (int)learntsize_adjust_confl;
     lbool   status            = l_Undef;
+    if (lbd_mode && next_reduce_db == 0)
+        next_reduce_db = conflicts + first_reduce_db;
+    // Learnt clauses only get a word for their LBD in 'lbd_mode':
+    ca.extra_lbd_field = lbd_mode;
 
     if (verbosity >= 1){
         printf("============================[ Search Statistics ]==============================\n");
@@ -775,6 +869,11 @@ lbool Solver::solve_()
         status = search(rest_base * restart_first);
         if (!withinBudget()) break;
         curr_restarts++;
+
+        if (status == l_Undef && clause_sharing != NULL){
+            clause_sharing->importClauses(*this);
+            if (!ok) status = l_False;
+        }
     }
 
     if (verbosity >= 1)
@@ -914,6 +1013,7 @@ void Solver::garbageCollect()
     // Initialize the next region to a size corresponding to the estimated utilization degree. This
     // is not precise but should avoid some unnecessary reallocations for the new region:
     ClauseAllocator to(ca.size() - ca.wasted()); 
+    to.extra_lbd_field = ca.extra_lbd_field;
 
     relocAll(to);
     if (verbosity >= 2)
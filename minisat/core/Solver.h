@@ -21,6 +21,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Minisat_Solver_h
 #define Minisat_Solver_h
 
+#include <atomic>
+
 #include "mtl/Vec.h"
 #include "mtl/Heap.h"
 #include "mtl/Alg.h"
@@ -30,6 +32,18 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 namespace Minisat {
 
+class Solver;
+
+//=================================================================================================
+// ClauseSharing -- an interface for exchanging learnt clauses between solvers of the same problem:
+
+class ClauseSharing {
+public:
+    virtual ~ClauseSharing() {}
+    virtual void exportClause (Solver& from, const vec<Lit>& c) = 0; // Called for each learnt unit and binary clause.
+    virtual void importClauses(Solver& to) = 0;                      // Called at decision level 0 after each restart; may add clauses with 'addClause()'.
+};
+
 //=================================================================================================
 // Solver -- the main class:
 
@@ -77,7 +91,9 @@ public:
     // Variable mode:
     // 
     void    setPolarity    (Var v, bool b); // Declare which polarity the decision heuristic should use for a variable. Requires mode 'polarity_user'.
+    bool    getPolarity    (Var v) const;   // The polarity the decision heuristic uses for a variable (with phase saving, the last value of the variable).
     void    setDecisionVar (Var v, bool b); // Declare if a variable should be eligible for selection in the decision heuristic.
+    void    setActivity    (Var v, double a); // Set the activity of a variable (e.g., to guide the first decisions). Should be small compared to the bumps, i.e., <= 1 initially.
 
     // Read state:
     //
@@ -133,6 +149,17 @@ public:
     int       learntsize_adjust_start_confl;
     double    learntsize_adjust_inc;
 
+    bool      lbd_mode;           // Manage learnt clauses by their LBD and restart dynamically (Glucose-style) instead of Luby/geometric restarts;
+                                  // must not be changed after the first call to 'solve()'. (default false)
+    int       lbd_glue;           // In 'lbd_mode', learnt clauses with at most this LBD are never removed.                  (default 2)
+    int       first_reduce_db;    // In 'lbd_mode', the number of conflicts before the first reduction of the learnt clauses. (default 2000)
+    int       inc_reduce_db;      // In 'lbd_mode', the increase of this interval after each reduction.                       (default 300)
+    int       restart_min_confl;  // In 'lbd_mode', the minimal number of conflicts between two restarts.                     (default 50)
+    double    restart_margin;     // In 'lbd_mode', restart if the fast moving average of the LBDs exceeds the slow one by this factor. (default 1.25)
+    double    restart_block;      // In 'lbd_mode', postpone restarts if the trail is longer than its moving average by this factor. (default 1.4)
+
+    ClauseSharing* clause_sharing; // If not NULL, learnt units and binary clauses are exchanged with other solvers. (default NULL)
+
     // Statistics: (read-only member variable)
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts;
@@ -204,11 +231,20 @@ protected:
     double              learntsize_adjust_confl;
     int                 learntsize_adjust_cnt;
 
+    vec<uint64_t>       lbd_stamp;        // Used by 'computeLBD()' to count each decision level once.
+    uint64_t            lbd_stamp_cnt;
+    uint64_t            lbd_samples;      // Number of LBDs in the moving averages.
+    double              lbd_ema_fast;     // Exponential moving averages of the LBDs of the learnt clauses (used for restarts in 'lbd_mode').
+    double              lbd_ema_slow;
+    double              trail_ema;        // Moving average of the trail size at conflicts (used for blocking restarts in 'lbd_mode').
+    uint64_t            next_reduce_db;   // In 'lbd_mode', the number of conflicts at which the learnt clauses are reduced next.
+    int                 reduce_db_cnt;
+
     // Resource contraints:
     //
     int64_t             conflict_budget;    // -1 means no budget.
     int64_t             propagation_budget; // -1 means no budget.
-    bool                asynch_interrupt;
+    std::atomic<bool>   asynch_interrupt;   // set by interrupt(), possibly from another thread.
 
     // Main internal methods:
     //
@@ -222,6 +258,9 @@ protected:
     void     analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel);    // (bt = backtrack)
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p, uint32_t abstract_levels);                       // (helper method for 'analyze()')
+    template<class Lits>
+    uint32_t computeLBD       (const Lits& ps);                                        // Number of distinct decision levels of the literals.
+    void     updateLBDAverages(uint32_t lbd);                                          // Add the LBD of a new learnt clause and the trail size to the moving averages.
     lbool    search           (int nof_conflicts);                                     // Search for a given number of conflicts.
     lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
@@ -301,6 +340,18 @@ inline void Solver::claBumpActivity (Clause& c) {
                 ca[learnts[i]].activity() *= 1e-20;
             cla_inc *= 1e-20; } }
 
+template<class Lits>
+inline uint32_t Solver::computeLBD(const Lits& ps) {
+    lbd_stamp.growTo(decisionLevel()+1, 0);
+    lbd_stamp_cnt++;
+    uint32_t lbd = 0;
+    for (int i = 0; i < ps.size(); i++){
+        int l = level(var(ps[i]));
+        if (lbd_stamp[l] != lbd_stamp_cnt){
+            lbd_stamp[l] = lbd_stamp_cnt;
+            lbd++; } }
+    return lbd; }
+
 inline void Solver::checkGarbage(void){ return checkGarbage(garbage_frac); }
 inline void Solver::checkGarbage(double gf){
     if (ca.wasted() > ca.size() * gf)
@@ -328,6 +379,8 @@ inline int      Solver::nLearnts      ()      const   { return learnts.size(); }
 inline int      Solver::nVars         ()      const   { return vardata.size(); }
 inline int      Solver::nFreeVars     ()      const   { return (int)dec_vars - (trail_lim.size() == 0 ? trail.size() : trail_lim[0]); }
 inline void     Solver::setPolarity   (Var v, bool b) { polarity[v] = b; }
+inline bool     Solver::getPolarity   (Var v) const   { return polarity[v]; }
+inline void     Solver::setActivity   (Var v, double a) { activity[v] = a; if (order_heap.inHeap(v)) order_heap.update(v); }
 inline void     Solver::setDecisionVar(Var v, bool b) 
 { 
     if      ( b && !decision[v]) dec_vars++;
@@ -338,11 +391,11 @@ inline void     Solver::setDecisionVar(Var v, bool b)
 }
 inline void     Solver::setConfBudget(int64_t x){ conflict_budget    = conflicts    + x; }
 inline void     Solver::setPropBudget(int64_t x){ propagation_budget = propagations + x; }
-inline void     Solver::interrupt(){ asynch_interrupt = true; }
-inline void     Solver::clearInterrupt(){ asynch_interrupt = false; }
+inline void     Solver::interrupt(){ asynch_interrupt.store(true, std::memory_order_relaxed); }
+inline void     Solver::clearInterrupt(){ asynch_interrupt.store(false, std::memory_order_relaxed); }
 inline void     Solver::budgetOff(){ conflict_budget = propagation_budget = -1; }
 inline bool     Solver::withinBudget() const {
-    return !asynch_interrupt &&
+    return !asynch_interrupt.load(std::memory_order_relaxed) &&
            (conflict_budget    < 0 || conflicts < (uint64_t)conflict_budget) &&
            (propagation_budget < 0 || propagations < (uint64_t)propagation_budget); }
 
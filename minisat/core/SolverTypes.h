@@ -125,18 +125,20 @@ class Clause {
         unsigned mark      : 2;
         unsigned learnt    : 1;
         unsigned has_extra : 1;
+        unsigned has_lbd   : 1;
         unsigned reloced   : 1;
-        unsigned size      : 27; }                            header;
+        unsigned size      : 26; }                            header;
     union { Lit lit; float act; uint32_t abs; CRef rel; } data[0];
 
     friend class ClauseAllocator;
 
     // NOTE: This constructor cannot be used directly (doesn't allocate enough memory).
     template<class V>
-    Clause(const V& ps, bool use_extra, bool learnt) {
+    Clause(const V& ps, bool use_extra, bool learnt, bool use_lbd) {
         header.mark      = 0;
         header.learnt    = learnt;
         header.has_extra = use_extra;
+        header.has_lbd   = use_extra && learnt && use_lbd;
         header.reloced   = 0;
         header.size      = ps.size();
 
@@ -144,8 +146,10 @@ class Clause {
             data[i].lit = ps[i];
 
         if (header.has_extra){
-            if (header.learnt)
-                data[header.size].act = 0; 
+            if (header.learnt){
+                data[header.size].act = 0;
+                if (header.has_lbd)
+                    data[header.size+1].abs = 0; }
             else 
                 calcAbstraction(); }
     }
@@ -160,10 +164,12 @@ public:
 
 
     int          size        ()      const   { return header.size; }
-    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size]; header.size -= i; }
+    void         shrink      (int i)         { assert(i <= size()); for (int k = 0; k < extraWords(); k++) data[header.size-i+k] = data[header.size+k]; header.size -= i; }
     void         pop         ()              { shrink(1); }
     bool         learnt      ()      const   { return header.learnt; }
     bool         has_extra   ()      const   { return header.has_extra; }
+    bool         has_lbd     ()      const   { return header.has_lbd; }
+    int          extraWords  ()      const   { return (int)header.has_extra + (int)header.has_lbd; }
     uint32_t     mark        ()      const   { return header.mark; }
     void         mark        (uint32_t m)    { header.mark = m; }
     const Lit&   last        ()      const   { return data[header.size-1].lit; }
@@ -180,6 +186,8 @@ public:
 
     float&       activity    ()              { assert(header.has_extra); return data[header.size].act; }
     uint32_t     abstraction () const        { assert(header.has_extra); return data[header.size].abs; }
+    // Literal block distance (number of distinct decision levels) of a learnt clause:
+    uint32_t&    lbd         ()              { assert(header.has_lbd); return data[header.size+1].abs; }
 
     Lit          subsumes    (const Clause& other) const;
     void         strengthen  (Lit p);
@@ -193,16 +201,20 @@ public:
 const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
 class ClauseAllocator : public RegionAllocator<uint32_t>
 {
-    static int clauseWord32Size(int size, bool has_extra){
-        return (sizeof(Clause) + (sizeof(Lit) * (size + (int)has_extra))) / sizeof(uint32_t); }
+    // Learnt clauses store their activity (and, if 'extra_lbd_field' is set, their LBD) after the literals, other clauses
+    // (optionally) their abstraction:
+    static int clauseWord32Size(int size, int extra_words){
+        return (sizeof(Clause) + (sizeof(Lit) * (size + extra_words))) / sizeof(uint32_t); }
  public:
     bool extra_clause_field;
+    bool extra_lbd_field;
 
-    ClauseAllocator(uint32_t start_cap) : RegionAllocator<uint32_t>(start_cap), extra_clause_field(false){}
-    ClauseAllocator() : extra_clause_field(false){}
+    ClauseAllocator(uint32_t start_cap) : RegionAllocator<uint32_t>(start_cap), extra_clause_field(false), extra_lbd_field(false){}
+    ClauseAllocator() : extra_clause_field(false), extra_lbd_field(false){}
 
     void moveTo(ClauseAllocator& to){
         to.extra_clause_field = extra_clause_field;
+        to.extra_lbd_field    = extra_lbd_field;
         RegionAllocator<uint32_t>::moveTo(to); }
 
     template<class Lits>
@@ -211,9 +223,10 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         assert(sizeof(Lit)      == sizeof(uint32_t));
         assert(sizeof(float)    == sizeof(uint32_t));
         bool use_extra = learnt | extra_clause_field;
+        bool use_lbd   = learnt & extra_lbd_field;
 
-        CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), use_extra));
-        new (lea(cid)) Clause(ps, use_extra, learnt);
+        CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), (int)use_extra + (int)use_lbd));
+        new (lea(cid)) Clause(ps, use_extra, learnt, use_lbd);
 
         return cid;
     }
@@ -228,7 +241,7 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
     void free(CRef cid)
     {
         Clause& c = operator[](cid);
-        RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), c.has_extra()));
+        RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), c.extraWords()));
     }
 
     void reloc(CRef& cr, ClauseAllocator& to)
@@ -243,7 +256,9 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         // Copy extra data-fields: 
         // (This could be cleaned-up. Generalize Clause-constructor to be applicable here instead?)
         to[cr].mark(c.mark());
-        if (to[cr].learnt())         to[cr].activity() = c.activity();
+        if (to[cr].learnt()){
+            to[cr].activity() = c.activity();
+            if (to[cr].has_lbd() && c.has_lbd()) to[cr].lbd() = c.lbd(); }
         else if (to[cr].has_extra()) to[cr].calcAbstraction();
     }
 };
@@ -333,7 +333,7 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
     while (subsumption_queue.size() > 0 || bwdsub_assigns < trail.size()){
 
         // Empty subsumption queue and return immediately on user-interrupt:
-        if (asynch_interrupt){
+        if (asynch_interrupt.load(std::memory_order_relaxed)){
             subsumption_queue.clear();
             bwdsub_assigns = trail.size();
             break; }
@@ -595,7 +595,7 @@ bool SimpSolver::eliminate(bool turn_off_elim)
             ok = false; goto cleanup; }
 
         // Empty elim_heap and return immediately on user-interrupt:
-        if (asynch_interrupt){
+        if (asynch_interrupt.load(std::memory_order_relaxed)){
             assert(bwdsub_assigns == trail.size());
             assert(subsumption_queue.size() == 0);
             assert(n_touched == 0);
@@ -606,7 +606,7 @@ bool SimpSolver::eliminate(bool turn_off_elim)
         for (int cnt = 0; !elim_heap.empty(); cnt++){
             Var elim = elim_heap.removeMin();
             
-            if (asynch_interrupt) break;
+            if (asynch_interrupt.load(std::memory_order_relaxed)) break;
 
             if (isEliminated(elim) || value(elim) != l_Undef) continue;
 
@@ -708,6 +708,7 @@ void SimpSolver::garbageCollect()
 
     cleanUpClauses();
     to.extra_clause_field = ca.extra_clause_field; // NOTE: this is important to keep (or lose) the extra fields.
+    to.extra_lbd_field    = ca.extra_lbd_field;
     relocAll(to);
     Solver::relocAll(to);
     if (verbosity >= 2)
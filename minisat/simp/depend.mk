@@ -0,0 +1,17 @@
+/root/repo/minisat/simp/Main.o /root/repo/minisat/simp/Main.or /root/repo/minisat/simp/Main.od /root/repo/minisat/simp/Main.op: /root/repo/minisat/simp/Main.cc /root/repo/minisat/utils/System.h \
+ /root/repo/minisat/mtl/IntTypes.h /root/repo/minisat/utils/ParseUtils.h \
+ /root/repo/minisat/utils/Options.h /root/repo/minisat/mtl/Vec.h \
+ /root/repo/minisat/mtl/XAlloc.h /root/repo/minisat/core/Dimacs.h \
+ /root/repo/minisat/core/SolverTypes.h /root/repo/minisat/mtl/Alg.h \
+ /root/repo/minisat/mtl/Map.h /root/repo/minisat/mtl/Alloc.h \
+ /root/repo/minisat/simp/SimpSolver.h /root/repo/minisat/mtl/Queue.h \
+ /root/repo/minisat/core/Solver.h /root/repo/minisat/mtl/Heap.h
+/root/repo/minisat/simp/SimpSolver.o /root/repo/minisat/simp/SimpSolver.or /root/repo/minisat/simp/SimpSolver.od /root/repo/minisat/simp/SimpSolver.op: /root/repo/minisat/simp/SimpSolver.cc \
+ /root/repo/minisat/mtl/Sort.h /root/repo/minisat/mtl/Vec.h \
+ /root/repo/minisat/mtl/IntTypes.h /root/repo/minisat/mtl/XAlloc.h \
+ /root/repo/minisat/simp/SimpSolver.h /root/repo/minisat/mtl/Queue.h \
+ /root/repo/minisat/core/Solver.h /root/repo/minisat/mtl/Heap.h \
+ /root/repo/minisat/mtl/Alg.h /root/repo/minisat/utils/Options.h \
+ /root/repo/minisat/utils/ParseUtils.h \
+ /root/repo/minisat/core/SolverTypes.h /root/repo/minisat/mtl/Map.h \
+ /root/repo/minisat/mtl/Alloc.h /root/repo/minisat/utils/System.h